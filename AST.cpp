@@ -1,11 +1,698 @@
 #include "AST.hpp"
 #include "symbol.hpp"
-#include "parser.hpp"
-#include "lexer.hpp"
+#include "formulaparser.hpp"
 #include "utility.hpp"
+#include "bitslicedevaluator.hpp"
+#include "flatformula.hpp"
+#include "tseitinencoder.hpp"
+#include "bddmanager.hpp"
+#include "modelchecker.hpp"
+#include "arena.hpp"
+#include "symboltable.hpp"
+#include "statementwalker.hpp"
+#include "statementvisitor.hpp"
+
+#include <algorithm>
+#include <iterator>
+
 using namespace AST;
 
-extern LogicStatement *entireStatement;
+/* Children queued by destructors running inside the outermost deletion */
+static thread_local QVector<LogicStatement *> *pendingDeletes = nullptr;
+
+static inline uint combine(uint seed, uint value)
+{
+	return seed ^ (value + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+}
+
+/* Union of two sorted id sets, sharing either one when it holds the other */
+static QVector<quint32> unite(const QVector<quint32> &left,
+                              const QVector<quint32> &right)
+{
+	if (right.isEmpty())
+		return left;
+	if (left.isEmpty())
+		return right;
+
+	QVector<quint32> ids;
+
+	ids.reserve(left.size() + right.size());
+	std::set_union(left.constBegin(), left.constEnd(), right.constBegin(),
+	               right.constEnd(), std::back_inserter(ids));
+
+	if (ids.size() == left.size())
+		return left;
+	if (ids.size() == right.size())
+		return right;
+	return ids;
+}
+
+static inline bool contains(const QVector<quint32> &ids, quint32 id)
+{
+	return std::binary_search(ids.constBegin(), ids.constEnd(), id);
+}
+
+#define SIMULATION_WORDS 4096
+/* Tables up to 2^18 rows take no longer to sweep than the simulation */
+#define SIMULATION_VARIABLE_THRESHOLD 18
+
+/* Writes the print of a node alone, stage being the number of its children
+ * printed so far, see StatementWalker::walk */
+class NodePrinter : public StatementVisitor<NodePrinter>
+{
+	bool fullBracket;
+	QString *out;
+	int stage;
+
+  public:
+	NodePrinter(bool fullBracket, QString *out)
+	    : fullBracket(fullBracket), out(out), stage(0)
+	{
+	}
+
+	void print(LogicStatement *statement, int stage)
+	{
+		this->stage = stage;
+		visit(statement);
+	}
+
+	void visitTruth(Truth *)
+	{
+		*out += SYMBOL_TRUTH;
+	}
+
+	void visitFalsity(Falsity *)
+	{
+		*out += SYMBOL_FALSITY;
+	}
+
+	void visitVariable(Variable *variable)
+	{
+		*out += variable->getName();
+	}
+
+	void visitUnary(UnaryOpStatement *statement)
+	{
+		bool bracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getStatement()) < 0;
+
+		if (stage == 0) {
+			*out += statement->symbol();
+			if (bracketed)
+				*out += QChar('(');
+		} else if (bracketed)
+			*out += QChar(')');
+	}
+
+	void visitBinary(BinaryOpStatement *statement)
+	{
+		bool leftBracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getLeftStatement()) < 0;
+		bool rightBracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getRightStatement()) <= 0;
+
+		switch (stage) {
+		case 0:
+			if (leftBracketed)
+				*out += QChar('(');
+			break;
+		case 1:
+			*out += leftBracketed ? QString(") ") : QString(" ");
+			*out += statement->symbol();
+			*out += rightBracketed ? QString(" (") : QString(" ");
+			break;
+		default:
+			if (rightBracketed)
+				*out += QChar(')');
+			break;
+		}
+	}
+
+	/* Quantified variable, then the body in brackets */
+	void visitForAll(ForAllStatement *)
+	{
+		quantifier(SYMBOL_FORALL);
+	}
+
+	void visitThereExists(ThereExistsStatement *)
+	{
+		quantifier(SYMBOL_THEREEXISTS);
+	}
+
+	void quantifier(QChar symbol)
+	{
+		if (stage == 0)
+			*out += symbol;
+		else
+			*out += stage == 1 ? QChar('(') : QChar(')');
+	}
+
+	void visitParameters(Parameters *parameters)
+	{
+		if (stage == 1 && parameters->getRemainingParameters() != nullptr)
+			*out += QString(", ");
+	}
+
+	/* Predicate symbol, then the parameters in brackets */
+	void visitPredicate(PredicateSymbolStatement *)
+	{
+		if (stage == 1)
+			*out += QChar('(');
+		else if (stage == 2)
+			*out += QChar(')');
+	}
+
+	void visitEquality(EqualityStatement *)
+	{
+		if (stage == 1)
+			*out += QString(" ") + QString(SYMBOL_EQUALS) + QString(" ");
+	}
+};
+
+/* Splits the print of a node into the tokens of getStringMapping, stage
+ * being as for NodePrinter. Variables inside first order statements map to
+ * nullptr, they mean nothing alone */
+class NodeTokeniser
+    : public StatementVisitor<NodeTokeniser, StatementWalker::Action>
+{
+	typedef QPair<QString, LogicStatement *> Token;
+
+	bool fullBracket;
+	QVector<Token> *mapping;
+	int stage;
+	/* Set when the next node is the variable of a quantifier */
+	bool inQuantifier;
+
+  public:
+	NodeTokeniser(bool fullBracket, QVector<Token> *mapping)
+	    : fullBracket(fullBracket), mapping(mapping), stage(0),
+	      inQuantifier(false)
+	{
+	}
+
+	StatementWalker::Action tokenise(LogicStatement *statement, int stage)
+	{
+		this->stage = stage;
+
+		/* Printed by the quantifier itself */
+		if (inQuantifier) {
+			inQuantifier = false;
+			return StatementWalker::SKIP_CHILDREN;
+		}
+
+		return visit(statement);
+	}
+
+	StatementWalker::Action visitTruth(Truth *truth)
+	{
+		mapping->append(Token(QString(SYMBOL_TRUTH), truth));
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitFalsity(Falsity *falsity)
+	{
+		mapping->append(Token(QString(SYMBOL_FALSITY), falsity));
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitVariable(Variable *variable)
+	{
+		mapping->append(Token(variable->getName(), variable));
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitUnary(UnaryOpStatement *statement)
+	{
+		bool bracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getStatement()) < 0;
+
+		if (stage == 0) {
+			mapping->append(Token(statement->symbol(), statement));
+			if (bracketed)
+				mapping->append(Token("(", nullptr));
+		} else if (bracketed)
+			mapping->append(Token(")", nullptr));
+
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitBinary(BinaryOpStatement *statement)
+	{
+		bool leftBracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getLeftStatement()) < 0;
+		bool rightBracketed =
+		    fullBracket || LogicStatement::comparePrecedence(
+		                       statement, statement->getRightStatement()) <= 0;
+
+		switch (stage) {
+		case 0:
+			if (leftBracketed)
+				mapping->append(Token("(", nullptr));
+			break;
+		case 1:
+			if (leftBracketed)
+				mapping->append(Token(")", nullptr));
+			mapping->append(Token(statement->symbol(), statement));
+			if (rightBracketed)
+				mapping->append(Token("(", nullptr));
+			break;
+		default:
+			if (rightBracketed)
+				mapping->append(Token(")", nullptr));
+			break;
+		}
+
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitForAll(ForAllStatement *statement)
+	{
+		quantifier(SYMBOL_FORALL, statement, statement->getQuantifier(),
+		           statement->getStatement());
+		return StatementWalker::CONTINUE;
+	}
+
+	StatementWalker::Action visitThereExists(ThereExistsStatement *statement)
+	{
+		quantifier(SYMBOL_THEREEXISTS, statement, statement->getQuantifier(),
+		           statement->getStatement());
+		return StatementWalker::CONTINUE;
+	}
+
+	/* Unlike print, the body is only bracketed when it has to be */
+	void quantifier(QChar symbol, LogicStatement *statement,
+	                Variable *identifier, LogicStatement *body)
+	{
+		bool bracketed = fullBracket || LogicStatement::comparePrecedence(
+		                                    statement, body) <= 0;
+
+		switch (stage) {
+		case 0:
+			mapping->append(Token(QString(symbol), statement));
+			mapping->append(Token(identifier->getName(), nullptr));
+			inQuantifier = true;
+			break;
+		case 1:
+			if (bracketed)
+				mapping->append(Token("(", nullptr));
+			break;
+		default:
+			if (bracketed)
+				mapping->append(Token(")", nullptr));
+			break;
+		}
+	}
+
+	StatementWalker::Action visitParameters(Parameters *parameters)
+	{
+		for (Parameters *rest = parameters; rest != nullptr;
+		     rest = rest->getRemainingParameters()) {
+			if (rest != parameters)
+				mapping->append(Token(",", nullptr));
+			mapping->append(Token(rest->getParameter()->getName(), nullptr));
+		}
+
+		return StatementWalker::SKIP_CHILDREN;
+	}
+
+	StatementWalker::Action visitPredicate(PredicateSymbolStatement *statement)
+	{
+		mapping->append(Token(statement->getPredicateSymbolName(), statement));
+		mapping->append(Token("(", nullptr));
+		visitParameters(statement->getParameters());
+		mapping->append(Token(")", nullptr));
+		return StatementWalker::SKIP_CHILDREN;
+	}
+
+	StatementWalker::Action visitEquality(EqualityStatement *statement)
+	{
+		mapping->append(
+		    Token(statement->getLeftVariable()->getName(), nullptr));
+		mapping->append(Token(QString(SYMBOL_EQUALS), statement));
+		mapping->append(
+		    Token(statement->getRightVariable()->getName(), nullptr));
+		return StatementWalker::SKIP_CHILDREN;
+	}
+};
+
+/* Value of a node from the values of its children */
+class NodeEvaluator : public StatementVisitor<NodeEvaluator, bool>
+{
+	const bool *operands;
+
+  public:
+	explicit NodeEvaluator(const bool *operands) : operands(operands)
+	{
+	}
+
+	bool visitTruth(Truth *)
+	{
+		return true;
+	}
+
+	bool visitFalsity(Falsity *)
+	{
+		return false;
+	}
+
+	bool visitVariable(Variable *variable)
+	{
+		return variable->getBooleanValue();
+	}
+
+	bool visitNot(NotStatement *)
+	{
+		return !operands[0];
+	}
+
+	bool visitAnd(AndStatement *)
+	{
+		return operands[0] && operands[1];
+	}
+
+	bool visitOr(OrStatement *)
+	{
+		return operands[0] || operands[1];
+	}
+
+	bool visitImplies(ImpliesStatement *)
+	{
+		return !operands[0] || operands[1];
+	}
+
+	bool visitIff(IffStatement *)
+	{
+		return operands[0] == operands[1];
+	}
+
+	/* First order statements have no boolean value */
+	bool visitFirstOrder(FirstOrderStatement *)
+	{
+		return false;
+	}
+
+	bool visitParameters(Parameters *)
+	{
+		return false;
+	}
+};
+
+/* Copy of a node over already copied children, children[1] is nullptr for
+ * the last parameter of a list */
+class NodeCloner : public StatementVisitor<NodeCloner, LogicStatement *>
+{
+	LogicStatement *const *children;
+
+  public:
+	explicit NodeCloner(LogicStatement *const *children) : children(children)
+	{
+	}
+
+	LogicStatement *visitTruth(Truth *)
+	{
+		return new Truth();
+	}
+
+	LogicStatement *visitFalsity(Falsity *)
+	{
+		return new Falsity();
+	}
+
+	LogicStatement *visitVariable(Variable *variable)
+	{
+		return new Variable(variable->getId());
+	}
+
+	LogicStatement *visitNot(NotStatement *)
+	{
+		return new NotStatement(children[0]);
+	}
+
+	LogicStatement *visitAnd(AndStatement *)
+	{
+		return new AndStatement(children[0], children[1]);
+	}
+
+	LogicStatement *visitOr(OrStatement *)
+	{
+		return new OrStatement(children[0], children[1]);
+	}
+
+	LogicStatement *visitImplies(ImpliesStatement *)
+	{
+		return new ImpliesStatement(children[0], children[1]);
+	}
+
+	LogicStatement *visitIff(IffStatement *)
+	{
+		return new IffStatement(children[0], children[1]);
+	}
+
+	LogicStatement *visitForAll(ForAllStatement *)
+	{
+		return new ForAllStatement(static_cast<Variable *>(children[0]),
+		                           children[1]);
+	}
+
+	LogicStatement *visitThereExists(ThereExistsStatement *)
+	{
+		return new ThereExistsStatement(static_cast<Variable *>(children[0]),
+		                                children[1]);
+	}
+
+	LogicStatement *visitParameters(Parameters *)
+	{
+		return new Parameters(static_cast<Variable *>(children[0]),
+		                      static_cast<Parameters *>(children[1]));
+	}
+
+	LogicStatement *visitPredicate(PredicateSymbolStatement *)
+	{
+		return new PredicateSymbolStatement(
+		    static_cast<Variable *>(children[0]),
+		    static_cast<Parameters *>(children[1]));
+	}
+
+	LogicStatement *visitEquality(EqualityStatement *)
+	{
+		return new EqualityStatement(static_cast<Variable *>(children[0]),
+		                             static_cast<Variable *>(children[1]));
+	}
+};
+
+/* Checks a node of a rule against the node of matchingStatement it lines up
+ * with, before their children are matched */
+class NodeMatcher : public StatementVisitor<NodeMatcher, bool>
+{
+	LogicStatement *matchingStatement;
+	EquivalenceUtility *matchingUtility;
+
+  public:
+	NodeMatcher(EquivalenceUtility *matchingUtility)
+	    : matchingStatement(nullptr), matchingUtility(matchingUtility)
+	{
+	}
+
+	bool match(LogicStatement *rule, LogicStatement *matchingStatement)
+	{
+		this->matchingStatement = matchingStatement;
+		return visit(rule);
+	}
+
+	/* Parameter lists of different lengths share a symbol */
+	bool visitStatement(LogicStatement *rule)
+	{
+		return rule->getSymbol() == matchingStatement->getSymbol() &&
+		       rule->childCount() == matchingStatement->childCount();
+	}
+
+	/* Rule variables bind to whole statements, so the children of
+	 * matchingStatement are never walked */
+	bool visitVariable(Variable *rule)
+	{
+		IDTable *idTable = matchingUtility->getIDTable();
+
+		/* For Leibneiz rule */
+		if (rule->getNotOccurVariable() != nullptr) {
+			/* If did occur, because the rule is Leibneiz so we know the value
+			 * of y in idTable */
+			if (!matchingStatement->notOccur(dynamic_cast<Variable *>(
+			        idTable->valueOf(rule->getNotOccurVariable()))))
+				return false;
+		}
+
+		/* For Leibneiz rule, we log the may occur variable in free Variable
+		 * list */
+		if (rule->getMayOccurVariable() != nullptr) {
+			matchingUtility->initFreeVariableList();
+			matchingStatement->collectFreeVariable(
+			    dynamic_cast<Variable *>(
+			        idTable->valueOf(rule->getMayOccurVariable())),
+			    matchingUtility->getFreeVariableList());
+		}
+
+		/* NOT_OCCUR_FREE */
+		if (rule->getBoundedVariable() != nullptr) {
+
+			/* Obtain Mapping from nested bound identifier to its mapped
+			 * variable */
+			Variable *mappedVariable = dynamic_cast<Variable *>(
+			    idTable->valueOf(rule->getBoundedVariable()));
+
+			/* Mapping known, need to confirm the variable is actually
+			 * bounded */
+			if (mappedVariable != nullptr) {
+				/* Variable not bounded, matching failure */
+				if (!matchingStatement->variableBounded(mappedVariable))
+					return false;
+
+				/* Variable bounded confirmed */
+
+				/* Mapping not known, need to find possible candidate for the
+				 * mapping */
+			} else {
+				/* Initialise rejection set with its representitive
+				 * identifier */
+				matchingUtility->initRejectionBoundVariableSet(
+				    rule->getBoundedVariable());
+
+				/* Log all possible bound candidates */
+				matchingStatement->rejectionBoundVariables(
+				    matchingStatement,
+				    matchingUtility->getRejectionBoundVariableSet());
+			}
+			/* OCCUR_FREE */
+		} else if (rule->getFreeVariable() != nullptr) {
+
+			/* Get the mapping from identifier of freeVariable to its
+			 * corresponding Variable, the mapping is assumed to be known */
+			Variable *mappedVariable = dynamic_cast<Variable *>(
+			    idTable->valueOf(rule->getFreeVariable()));
+
+			/* Initialise free variable list, if not already
+			 * initialised(checked by function) */
+			matchingUtility->initFreeVariableList();
+
+			/* Log all variables that are free in matchingStatement and equals
+			 * to mappedVariable */
+			matchingStatement->collectFreeVariable(
+			    mappedVariable, matchingUtility->getFreeVariableList());
+		}
+
+		return idTable->add(rule, matchingStatement);
+	}
+
+	bool visitForAll(ForAllStatement *rule)
+	{
+		if (rule->getSymbol() != matchingStatement->getSymbol())
+			return false;
+
+		ForAllStatement *castedMatchingStatement =
+		    static_cast<ForAllStatement *>(matchingStatement);
+		Variable *loggedBoundVariable = matchingUtility->getBoundVariable();
+
+		/* In case where the bound variable has been logged for candidate
+		 * search an Example would be
+		 * FORALL(x)(A V B)=A V FORALL(x)(B) where x occurs free in A, in the
+		 * latter rule, the A will be matched and candidates for x would be
+		 * logged, and the second half must confirm one of the logged
+		 * candidates for x is the current one it is matching onto */
+		if (loggedBoundVariable != nullptr &&
+		    loggedBoundVariable->equals(rule->getQuantifier())) {
+			/* Current quantifier in actual statement is not matched to any
+			 * candidate */
+			if (matchingUtility->inRejectionBoundVariableSet(
+			        castedMatchingStatement->getQuantifier()))
+				return false;
+
+			/* When control reaches this block, the binding has been confirmed
+			 * and candidate set is no longer needed, in fact keeping the
+			 * information would confuse the matching system */
+			matchingUtility->deleteAuxiliaryItems();
+			matchingUtility->resetAuxiliaryItems();
+			/* Used for renaming bound variables, inserting the x in FORALL(x)A
+			 * to the free list to be replaced later on */
+		} else if (rule->getStatement()->getSymbol() == VARIABLE_SYMBOL &&
+		           static_cast<Variable *>(rule->getStatement())
+		                   ->getFreeVariable() != nullptr) {
+			matchingUtility->initFreeVariableList();
+			matchingUtility->getFreeVariableList()->append(
+			    castedMatchingStatement->getQuantifier());
+		}
+
+		/* The quantifier is then added to IDTable as usual and matching goes
+		 * on */
+		return true;
+	}
+
+	bool visitThereExists(ThereExistsStatement *rule)
+	{
+		if (rule->getSymbol() != matchingStatement->getSymbol())
+			return false;
+
+		ThereExistsStatement *castedMatchingStatement =
+		    static_cast<ThereExistsStatement *>(matchingStatement);
+		Variable *loggedBoundVariable = matchingUtility->getBoundVariable();
+
+		/* In case where the bound variable has been logged for candidate
+		 * search an Example would be
+		 * THEREEXIST(x)(A ^ B)=A ^ THEREEXIST(x)(B) where x occurs free in A,
+		 * in the latter rule, the A will be matched and candidates for x
+		 * would be logged, and the second half must confirm one of the logged
+		 * candidates for x is the current one it is matching onto */
+		if (loggedBoundVariable != nullptr &&
+		    loggedBoundVariable->equals(rule->getQuantifier())) {
+			/* Current quantifier in actual statement is not matched to any
+			 * candidate */
+			if (matchingUtility->inRejectionBoundVariableSet(
+			        castedMatchingStatement->getQuantifier()))
+				return false;
+
+			/* When control reaches this block, the binding has been confirmed
+			 * and candidate set is no longer needed, in fact keeping the
+			 * information would confuse the matching system */
+			matchingUtility->resetAuxiliaryItems();
+
+			/* Used for renaming bound variables, inserting the x in FORALL(x)A
+			 * to the free list to be replaced later on */
+		} else if (rule->getStatement()->getSymbol() == VARIABLE_SYMBOL &&
+		           static_cast<Variable *>(rule->getStatement())
+		                   ->getFreeVariable() != nullptr) {
+			matchingUtility->initFreeVariableList();
+			matchingUtility->getFreeVariableList()->append(
+			    castedMatchingStatement->getQuantifier());
+		}
+
+		/* The quantifier is then added to IDTable as usual and matching goes
+		 * on */
+		return true;
+	}
+};
+
+/* Added just for Leibniz Rule, checked on a rule of the shape (x=y) IMPLIES
+ * (A IFF B) once it has matched. x is confirmed free in A and y free in B
+ * and y does not occur in A, so the idTable has mapping for x,y,A and B */
+static bool leibnizMatched(EquivalenceUtility *matchingUtility)
+{
+	IDTable *idTable = matchingUtility->getIDTable();
+	QString A("A");
+	QString B("B");
+	Variable VAR_A(A);
+	Variable VAR_B(B);
+	LogicStatement *matching_A = idTable->valueOf(&VAR_A);
+	LogicStatement *matching_B = idTable->valueOf(&VAR_B);
+
+	/* When one or more free x gets replaced by y, Leibniz rule matched, if
+	 * none gets replaced or structural mismatch, then failed to match leibniz
+	 * rule */
+	return matching_A->numberOfLeibnizReplacedVariable(matching_B,
+	                                                   matchingUtility) > 0;
+}
 
 /* LogicStatement Class */
 void LogicStatement::list_destroy(QVector<QVector<Variable *> *> *var_list)
@@ -16,59 +703,470 @@ void LogicStatement::list_destroy(QVector<QVector<Variable *> *> *var_list)
 	delete var_list;
 }
 
-bool LogicStatement::isEquivalent(LogicStatement *statement)
+bool LogicStatement::isEquivalent(LogicStatement *statement,
+                                  QMap<QString, bool> *counterexample)
 {
+	FlatFormula left(this);
+	FlatFormula right(statement);
 
-	if (isFirstOrderLogic() || statement->isFirstOrderLogic())
+	/* Identical formulas need no checking, flat ones compare as arrays */
+	if (left == right)
 		return true;
 
-	auto var_list = new QVector<QVector<Variable *> *>();
+	/* Finite models can refute first order equivalence but never prove it */
+	if (isFirstOrderLogic() || statement->isFirstOrderLogic())
+		return ModelChecker(this, statement).check() !=
+		       ModelChecker::DISTINGUISHED;
 
-	collectVariables(var_list);
-	statement->collectVariables(var_list);
+	BitSlicedEvaluator evaluator(left, right);
+
+	/* Most pairs that differ do so on many rows, a few thousand random rows
+	 * settle them long before a complete check would */
+	if (evaluator.variableCount() > SIMULATION_VARIABLE_THRESHOLD &&
+	    evaluator.refute(SIMULATION_WORDS, counterexample))
+		return false;
+
+	bool equivalent;
+
+	if (evaluator.isEquivalent(&equivalent, counterexample))
+		return equivalent;
+
+	/* Truth tables beyond a couple of dozen variables are out of reach, wide
+	 * formulas go to the shared BDD manager and, when the diagrams grow
+	 * past its node limit, to the SAT solver. Diagrams do not name an
+	 * assignment, the solver is asked for one */
+	if (BddManager::globalManager()->isEquivalent(this, statement,
+	                                              &equivalent) &&
+	    (equivalent || !counterexample))
+		return equivalent;
+
+	return TseitinEncoder::isEquivalent(this, statement, counterexample);
+}
+
+int LogicStatement::comparePrecedence(LogicStatement *outer,
+                                      LogicStatement *inner)
+{
+	return outer->getSymbol() - inner->getSymbol();
+}
+
+LogicStatement::LogicStatement(Symbol symbol) : concreteSymbol(symbol)
+{
+}
+
+Symbol LogicStatement::getSymbol()
+{
+	return concreteSymbol;
+}
+
+LogicStatement::~LogicStatement()
+{
+	delete summary;
+}
+
+LogicStatement::Summary *LogicStatement::getSummary()
+{
+	if (summary != nullptr)
+		return summary;
+
+	/* Children are summarised before their parent, subtrees still
+	 * summarised are not walked again */
+	StatementWalker::walk(this, [](LogicStatement *statement, int stage) {
+		if (stage == 0 && statement->summary != nullptr)
+			return StatementWalker::SKIP_CHILDREN;
+
+		if (statement->getChild(stage) == nullptr)
+			statement->summarise();
+
+		return StatementWalker::CONTINUE;
+	});
+
+	return summary;
+}
+
+void LogicStatement::summarise()
+{
+	Symbol symbol = getSymbol();
+	Summary result{uint(symbol), 1, 1, QVector<quint32>(), QVector<quint32>()};
+	/* Child whose variables do not count as free here, the predicate symbol
+	 * occurs but is never free */
+	LogicStatement *notFreeChild = nullptr;
+
+	if (symbol == VARIABLE_SYMBOL) {
+		quint32 id = static_cast<Variable *>(this)->getId();
+		result.hash = combine(result.hash, id);
+		result.freeVariables.append(id);
+		result.occurringVariables.append(id);
+	}
+
+	if (symbol == FORALL_SYMBOL || symbol == THEREEXISTS_SYMBOL ||
+	    symbol == PREDICATE_SYMBOL)
+		notFreeChild = getChild(0);
+
+	for (int index = 0; index < 2; ++index) {
+		LogicStatement *child = getChild(index);
+		Summary *childSummary = child ? child->summary : nullptr;
+
+		result.hash = combine(result.hash, child ? childSummary->hash : 0);
+
+		if (child == nullptr)
+			continue;
+
+		result.size += childSummary->size;
+		result.depth = qMax(result.depth, childSummary->depth + 1);
+		result.occurringVariables = unite(result.occurringVariables,
+		                                  childSummary->occurringVariables);
+
+		if (child != notFreeChild)
+			result.freeVariables =
+			    unite(result.freeVariables, childSummary->freeVariables);
+	}
+
+	/* A quantifier binds its variable in the body */
+	if (symbol == FORALL_SYMBOL || symbol == THEREEXISTS_SYMBOL) {
+		quint32 id = static_cast<Variable *>(notFreeChild)->getId();
+		auto bound = std::lower_bound(result.freeVariables.constBegin(),
+		                              result.freeVariables.constEnd(), id);
+
+		if (bound != result.freeVariables.constEnd() && *bound == id)
+			result.freeVariables.remove(
+			    int(bound - result.freeVariables.constBegin()));
+	}
+
+	if (summary == nullptr)
+		summary = new Summary(result);
+	else
+		*summary = result;
+}
+
+void LogicStatement::invalidateSummary()
+{
+	delete summary;
+	summary = nullptr;
+}
+
+void LogicStatement::childChanged(LogicStatement *child)
+{
+	if (child->summary == nullptr)
+		invalidateSummary();
+}
+
+bool LogicStatement::occursFree(Variable *var)
+{
+	return var != nullptr &&
+	       contains(getSummary()->freeVariables, var->getId());
+}
+
+bool LogicStatement::occurs(Variable *var)
+{
+	return var != nullptr &&
+	       contains(getSummary()->occurringVariables, var->getId());
+}
+
+uint LogicStatement::structuralHash()
+{
+	return getSummary()->hash;
+}
+
+int LogicStatement::nodeCount()
+{
+	return getSummary()->size;
+}
+
+int LogicStatement::depth()
+{
+	return getSummary()->depth;
+}
+
+void LogicStatement::invalidateSummaries()
+{
+	/* A node without a summary may still have summarised descendants */
+	StatementWalker::walk(this, [](LogicStatement *statement, int stage) {
+		if (stage == 0)
+			statement->invalidateSummary();
+		return StatementWalker::CONTINUE;
+	});
+}
+
+LogicStatement *LogicStatement::getChild(int index)
+{
+	LogicStatement *children[2];
 
-	if (var_list->empty()) {
-		list_destroy(var_list);
-		return evaluate() == statement->evaluate();
+	if (index < 0 || index >= 2)
+		return nullptr;
+
+	getChildren(children);
+	return children[index];
+}
+
+void LogicStatement::getChildren(LogicStatement *children[2])
+{
+	children[0] = nullptr;
+	children[1] = nullptr;
+
+	switch (getSymbol()) {
+	case VARIABLE_SYMBOL:
+	case TRUTH_SYMBOL:
+	case FALSITY_SYMBOL:
+		break;
+	case NOT_SYMBOL:
+		children[0] = static_cast<UnaryOpStatement *>(this)->getStatement();
+		break;
+	case FORALL_SYMBOL:
+		children[0] = static_cast<ForAllStatement *>(this)->getQuantifier();
+		children[1] = static_cast<ForAllStatement *>(this)->getStatement();
+		break;
+	case THEREEXISTS_SYMBOL:
+		children[0] =
+		    static_cast<ThereExistsStatement *>(this)->getQuantifier();
+		children[1] = static_cast<ThereExistsStatement *>(this)->getStatement();
+		break;
+	case PARAMETERS_SYMBOL:
+		children[0] = static_cast<Parameters *>(this)->getParameter();
+		children[1] = static_cast<Parameters *>(this)->getRemainingParameters();
+		break;
+	case PREDICATE_SYMBOL:
+		children[0] =
+		    static_cast<PredicateSymbolStatement *>(this)->getPredicateSymbol();
+		children[1] =
+		    static_cast<PredicateSymbolStatement *>(this)->getParameters();
+		break;
+	case EQUALS_SYMBOL:
+		children[0] = static_cast<EqualityStatement *>(this)->getLeftVariable();
+		children[1] =
+		    static_cast<EqualityStatement *>(this)->getRightVariable();
+		break;
+	default:
+		children[0] =
+		    static_cast<BinaryOpStatement *>(this)->getLeftStatement();
+		children[1] =
+		    static_cast<BinaryOpStatement *>(this)->getRightStatement();
+		break;
 	}
+}
 
-	int list_size = var_list->size();
-	unsigned int total_combinations = list_size * list_size;
-	unsigned int current_combination;
-	unsigned int shifted_combination;
-	bool value;
+int LogicStatement::childCount()
+{
+	int count = 0;
 
-	for (current_combination = 0; current_combination < total_combinations;
-	     ++current_combination) {
-		shifted_combination = current_combination;
+	while (getChild(count) != nullptr)
+		++count;
 
-		for (QVector<Variable *> *identicalVar_list : *var_list) {
-			value = shifted_combination % 2;
+	return count;
+}
 
-			for (Variable *variable : *identicalVar_list)
-				variable->setBooleanValue(value);
+QString LogicStatement::print(bool fullBracket)
+{
+	QString out;
+	print(fullBracket, &out);
+	return out;
+}
+
+void LogicStatement::print(bool fullBracket, QString *out,
+                           QHash<LogicStatement *, QPair<int, int> > *spans)
+{
+	NodePrinter printer(fullBracket, out);
+
+	StatementWalker::walk(this, [&printer, out, spans](
+	                                LogicStatement *statement, int stage) {
+		if (spans != nullptr && stage == 0)
+			spans->insert(statement, QPair<int, int>(out->size(), 0));
 
-			shifted_combination /= 2;
+		printer.print(statement, stage);
+
+		if (spans != nullptr && statement->getChild(stage) == nullptr) {
+			QPair<int, int> &span = (*spans)[statement];
+			span.second = out->size() - span.first;
 		}
 
-		if (evaluate() != statement->evaluate()) {
-			list_destroy(var_list);
-			return false;
+		return StatementWalker::CONTINUE;
+	});
+}
+
+QVector<QPair<QString, LogicStatement *> >
+LogicStatement::getStringMapping(bool fullBracket)
+{
+	QVector<QPair<QString, LogicStatement *> > mapping;
+	getStringMapping(fullBracket, &mapping);
+	return mapping;
+}
+
+void LogicStatement::getStringMapping(
+    bool fullBracket, QVector<QPair<QString, LogicStatement *> > *mapping)
+{
+	NodeTokeniser tokeniser(fullBracket, mapping);
+
+	StatementWalker::walk(this, [&tokeniser](LogicStatement *statement,
+	                                         int stage) {
+		return tokeniser.tokenise(statement, stage);
+	});
+}
+
+bool LogicStatement::isFirstOrderLogic()
+{
+	/* Stops at the first first order node */
+	return !StatementWalker::walk(this, [](LogicStatement *statement, int) {
+		switch (statement->getSymbol()) {
+		case FORALL_SYMBOL:
+		case THEREEXISTS_SYMBOL:
+		case EQUALS_SYMBOL:
+		case PARAMETERS_SYMBOL:
+		case PREDICATE_SYMBOL:
+			return StatementWalker::STOP;
+		default:
+			return StatementWalker::CONTINUE;
 		}
+	});
+}
+
+bool LogicStatement::evaluate()
+{
+	QVector<bool> values;
+
+	/* Values of the children are the topmost ones once the last is done */
+	StatementWalker::walk(this, [&values](LogicStatement *statement,
+	                                      int stage) {
+		if (statement->getChild(stage) == nullptr) {
+			bool operands[2] = {false, false};
+			int first = values.size() - stage;
+
+			for (int index = 0; index < stage; ++index)
+				operands[index] = values.at(first + index);
+
+			values.resize(first);
+			values.append(NodeEvaluator(operands).visit(statement));
+		}
+
+		return StatementWalker::CONTINUE;
+	});
+
+	return values.last();
+}
+
+void LogicStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
+{
+	StatementWalker::walk(this, [var_list](LogicStatement *statement,
+	                                       int stage) {
+		if (stage != 0 || statement->getSymbol() != VARIABLE_SYMBOL)
+			return StatementWalker::CONTINUE;
+
+		Variable *variable = static_cast<Variable *>(statement);
+
+		for (QVector<Variable *> *identicalVar_list : *var_list)
+			if (identicalVar_list->front()->getId() == variable->getId()) {
+				identicalVar_list->push_back(variable);
+				return StatementWalker::CONTINUE;
+			}
+
+		auto new_list = new QVector<Variable *>();
+		new_list->push_back(variable);
+		var_list->push_back(new_list);
+		return StatementWalker::CONTINUE;
+	});
+}
+
+bool LogicStatement::equals(LogicStatement *statement)
+{
+	/* Nodes are compared on arrival, so children always pair up */
+	return StatementWalker::walkPair(
+	    this, statement,
+	    [](LogicStatement *first, LogicStatement *second, int stage) {
+		    if (stage != 0)
+			    return StatementWalker::CONTINUE;
+
+		    if (first->getSymbol() != second->getSymbol() ||
+		        first->childCount() != second->childCount())
+			    return StatementWalker::STOP;
+
+		    if (first->getSymbol() == VARIABLE_SYMBOL &&
+		        static_cast<Variable *>(first)->getId() !=
+		            static_cast<Variable *>(second)->getId())
+			    return StatementWalker::STOP;
+
+		    return StatementWalker::CONTINUE;
+	    });
+}
+
+bool LogicStatement::match(LogicStatement *matchingStatement,
+                           EquivalenceUtility *matchingUtility)
+{
+	NodeMatcher matcher(matchingUtility);
+
+	return StatementWalker::walkPair(
+	    this, matchingStatement,
+	    [&matcher, matchingUtility](LogicStatement *rule,
+	                                LogicStatement *matching, int stage) {
+		    if (stage == 0 && !matcher.match(rule, matching))
+			    return StatementWalker::STOP;
+
+		    /* Every child has matched, rules of the shape (x=y) IMPLIES
+		     * (A IFF B) are checked as a whole */
+		    if (rule->getChild(stage) == nullptr &&
+		        rule->getSymbol() == IMPLIES_SYMBOL && rule->isLeibnizRule() &&
+		        !leibnizMatched(matchingUtility))
+			    return StatementWalker::STOP;
+
+		    return StatementWalker::CONTINUE;
+	    });
+}
+
+LogicStatement *LogicStatement::clone()
+{
+	QVector<LogicStatement *> copies;
+
+	/* Copies of the children are the topmost ones once the last is done */
+	StatementWalker::walk(this, [&copies](LogicStatement *statement,
+	                                      int stage) {
+		if (statement->getChild(stage) == nullptr) {
+			LogicStatement *children[2] = {nullptr, nullptr};
+			int first = copies.size() - stage;
+
+			for (int index = 0; index < stage; ++index)
+				children[index] = copies.at(first + index);
+
+			copies.resize(first);
+			copies.append(NodeCloner(children).visit(statement));
+		}
+
+		return StatementWalker::CONTINUE;
+	});
+
+	return copies.last();
+}
+
+bool LogicStatement::operator==(LogicStatement &other)
+{
+	return equals(&other);
+}
+
+void LogicStatement::deleteChild(LogicStatement *child)
+{
+	if (child == nullptr)
+		return;
+
+	if (pendingDeletes != nullptr) {
+		pendingDeletes->append(child);
+		return;
 	}
 
-	list_destroy(var_list);
-	return true;
+	QVector<LogicStatement *> pending;
+
+	pendingDeletes = &pending;
+	delete child;
+
+	while (!pending.isEmpty())
+		delete pending.takeLast();
+
+	pendingDeletes = nullptr;
 }
 
-int LogicStatement::comparePrecedence(LogicStatement *outer,
-                                      LogicStatement *inner)
+void *LogicStatement::operator new(size_t size)
 {
-	return outer->getSymbol() - inner->getSymbol();
+	return Arena::allocate(size);
 }
 
-LogicStatement::~LogicStatement()
+void LogicStatement::operator delete(void *memory)
 {
+	Arena::release(memory);
 }
 
 void LogicStatement::setRuleType(bool isLeibnizRule)
@@ -111,63 +1209,15 @@ LogicSet *LogicStatement::getExtraVariables(LogicStatement *other)
 }
 
 /* Truth Class */
-QString Truth::print(bool)
-{
-	return SYMBOL_TRUTH;
-}
-
-bool Truth::isFirstOrderLogic()
-{
-	return false;
-}
-
-Symbol Truth::getSymbol()
-{
-	return Symbol::TRUTH_SYMBOL;
-}
-
-bool Truth::evaluate()
-{
-	return true;
-}
-
-void Truth::collectVariables(QVector<QVector<Variable *> *> *)
+Truth::Truth() : LogicStatement(TRUTH_SYMBOL)
 {
 }
 
-bool Truth::equals(LogicStatement *statement)
-{
-	return statement->getSymbol() == getSymbol();
-}
-
-bool Truth::match(LogicStatement *matchingStatement, EquivalenceUtility *)
-{
-	return getSymbol() == matchingStatement->getSymbol();
-}
-
 LogicStatement *Truth::replace(IDTable *)
 {
 	return this;
 }
 
-LogicStatement *Truth::clone()
-{
-	return new Truth();
-}
-
-bool Truth::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol();
-}
-
-QVector<QPair<QString, LogicStatement *> > Truth::getStringMapping(bool)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-	mapping.append(
-	    QPair<QString, LogicStatement *>(QString(SYMBOL_TRUTH), this));
-	return mapping;
-}
-
 bool Truth::variableBounded(Variable *)
 {
 	/* No constraint on constant, so variable is bounded. */
@@ -216,38 +1266,8 @@ bool Truth::validFirstOrderStatement()
 }
 
 /* Falsity Class */
-QString Falsity::print(bool)
-{
-	return SYMBOL_FALSITY;
-}
-
-bool Falsity::isFirstOrderLogic()
-{
-	return false;
-}
-
-Symbol Falsity::getSymbol()
-{
-	return Symbol::FALSITY_SYMBOL;
-}
-
-bool Falsity::evaluate()
-{
-	return false;
-}
-
-void Falsity::collectVariables(QVector<QVector<Variable *> *> *)
-{
-}
-
-bool Falsity::equals(LogicStatement *statement)
-{
-	return statement->getSymbol() == getSymbol();
-}
-
-bool Falsity::match(LogicStatement *matchingStatement, EquivalenceUtility *)
+Falsity::Falsity() : LogicStatement(FALSITY_SYMBOL)
 {
-	return getSymbol() == matchingStatement->getSymbol();
 }
 
 LogicStatement *Falsity::replace(IDTable *)
@@ -255,24 +1275,6 @@ LogicStatement *Falsity::replace(IDTable *)
 	return this;
 }
 
-LogicStatement *Falsity::clone()
-{
-	return new Falsity();
-}
-
-bool Falsity::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol();
-}
-
-QVector<QPair<QString, LogicStatement *> > Falsity::getStringMapping(bool)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-	mapping.append(
-	    QPair<QString, LogicStatement *>(QString(SYMBOL_FALSITY), this));
-	return mapping;
-}
-
 bool Falsity::variableBounded(Variable *)
 {
 	/* No constraint on constant, so variable is bounded. */
@@ -322,8 +1324,13 @@ bool Falsity::validFirstOrderStatement()
 
 /* Variable Class */
 Variable::Variable(QString &name)
+    : Variable(SymbolTable::globalTable()->intern(name))
+{
+}
+
+Variable::Variable(quint32 id)
+    : LogicStatement(VARIABLE_SYMBOL), id(id), value(false)
 {
-	setName(name);
 	freeVariable = nullptr;
 	boundedVariable = nullptr;
 	notOccurVariable = nullptr;
@@ -345,29 +1352,20 @@ Variable::~Variable()
 		delete notOccurVariable;
 }
 
-QString Variable::print(bool)
+const QString &Variable::getName()
 {
-	return getName();
+	return SymbolTable::globalTable()->spelling(id);
 }
 
-QString &Variable::getName()
+quint32 Variable::getId()
 {
-	return name;
+	return id;
 }
 
 void Variable::setName(QString name)
 {
-	this->name = name;
-}
-
-bool Variable::isFirstOrderLogic()
-{
-	return false;
-}
-
-Symbol Variable::getSymbol()
-{
-	return Symbol::VARIABLE_SYMBOL;
+	invalidateSummary();
+	id = SymbolTable::globalTable()->intern(name);
 }
 
 void Variable::setBooleanValue(bool value)
@@ -375,101 +1373,11 @@ void Variable::setBooleanValue(bool value)
 	this->value = value;
 }
 
-bool Variable::evaluate()
+bool Variable::getBooleanValue()
 {
 	return value;
 }
 
-bool Variable::equals(LogicStatement *statement)
-{
-	return statement->getSymbol() == getSymbol() &&
-	       dynamic_cast<Variable *>(statement)->getName() == getName();
-}
-
-void Variable::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-
-	if (!var_list->empty())
-		for (QVector<Variable *> *identicalVar_list : *var_list)
-			if (identicalVar_list->front()->equals(this)) {
-				identicalVar_list->push_back(this);
-				return;
-			}
-
-	auto new_list = new QVector<Variable *>();
-	new_list->push_back(this);
-	var_list->push_back(new_list);
-}
-
-bool Variable::match(LogicStatement *matchingStatement,
-                     EquivalenceUtility *matchingUtility)
-{
-	IDTable *idTable = matchingUtility->getIDTable();
-
-	/* For Leibneiz rule */
-	if (notOccurVariable != nullptr) {
-		/* If did occur, because the rule is Leibneiz so we know the value of y
-		 * in idTable */
-		if (!matchingStatement->notOccur(
-		         dynamic_cast<Variable *>(idTable->valueOf(notOccurVariable))))
-			return false;
-	}
-
-	/* For Leibneiz rule, we log the may occur variable in free Variable list */
-	if (mayOccurVariable != nullptr) {
-		matchingUtility->initFreeVariableList();
-		matchingStatement->collectFreeVariable(
-		    dynamic_cast<Variable *>(idTable->valueOf(mayOccurVariable)),
-		    matchingUtility->getFreeVariableList());
-	}
-
-	/* NOT_OCCUR_FREE */
-	if (boundedVariable != nullptr) {
-
-		/* Obtain Mapping from nested bound identifier to its mapped variable */
-		Variable *mappedVariable =
-		    dynamic_cast<Variable *>(idTable->valueOf(boundedVariable));
-
-		/* Mapping known, need to confirm the variable is actually bounded */
-		if (mappedVariable != nullptr) {
-			/* Variable not bounded, matching failure */
-			if (!matchingStatement->variableBounded(mappedVariable))
-				return false;
-
-			/* Variable bounded confirmed */
-
-			/* Mapping not known, need to find possible candidate for the
-			 * mapping */
-		} else {
-			/* Initialise rejection set with its representitive identifier */
-			matchingUtility->initRejectionBoundVariableSet(boundedVariable);
-
-			/* Log all possible bound candidates */
-			matchingStatement->rejectionBoundVariables(
-			    matchingStatement,
-			    matchingUtility->getRejectionBoundVariableSet());
-		}
-		/* OCCUR_FREE */
-	} else if (freeVariable != nullptr) {
-
-		/* Get the mapping from identifier of freeVariable to its corresponding
-		 * Variable, the mapping is assumed to be known */
-		Variable *mappedVariable =
-		    dynamic_cast<Variable *>(idTable->valueOf(freeVariable));
-
-		/* Initialise free variable list, if not already initialised(checked by
-		 * function) */
-		matchingUtility->initFreeVariableList();
-
-		/* Log all variables that are free in matchingStatement and equals to
-		 * mappedVariable */
-		matchingStatement->collectFreeVariable(
-		    mappedVariable, matchingUtility->getFreeVariableList());
-	}
-
-	return idTable->add(this, matchingStatement);
-}
-
 LogicStatement *Variable::replace(IDTable *idTable)
 {
 	LogicStatement *replacedStatement = idTable->valueOf(this)->clone();
@@ -477,24 +1385,6 @@ LogicStatement *Variable::replace(IDTable *idTable)
 	return replacedStatement;
 }
 
-LogicStatement *Variable::clone()
-{
-	return new Variable(getName());
-}
-
-bool Variable::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       getName() == dynamic_cast<Variable &>(other).getName();
-}
-
-QVector<QPair<QString, LogicStatement *> > Variable::getStringMapping(bool)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-	mapping.append(QPair<QString, LogicStatement *>(getName(), this));
-	return mapping;
-}
-
 bool Variable::variableBounded(Variable *boundedVariable)
 {
 	/* A variable is bounded if either it is caght in ThereExists or ForAll
@@ -620,8 +1510,13 @@ bool Variable::validFirstOrderStatement()
 }
 
 /* UnaryOpStatement Class (Virtual) */
+UnaryOpStatement::UnaryOpStatement(Symbol symbol) : LogicStatement(symbol)
+{
+}
+
 void UnaryOpStatement::setStatement(LogicStatement *statement)
 {
+	invalidateSummary();
 	nestedStatement = statement;
 }
 
@@ -630,88 +1525,30 @@ LogicStatement *UnaryOpStatement::getStatement()
 	return nestedStatement;
 }
 
-void
-UnaryOpStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getStatement()->collectVariables(var_list);
-}
-
-bool UnaryOpStatement::equals(LogicStatement *statement)
-{
-	return statement->getSymbol() == getSymbol() &&
-	       getStatement()->equals(
-	           dynamic_cast<UnaryOpStatement *>(statement)->getStatement());
-}
-
-bool UnaryOpStatement::match(LogicStatement *matchingStatement,
-                             EquivalenceUtility *matchingUtility)
-{
-	return getSymbol() == matchingStatement->getSymbol() &&
-	       getStatement()->match(dynamic_cast<UnaryOpStatement *>(
-	                                 matchingStatement)->getStatement(),
-	                             matchingUtility);
-}
-
 LogicStatement *UnaryOpStatement::replace(IDTable *idTable)
 {
 	setStatement(getStatement()->replace(idTable));
 	return this;
 }
 
-QString UnaryOpStatement::print(bool fullBracket)
-{
-	QString SYMBOL = symbol();
-
-	if (!fullBracket && (comparePrecedence(this, getStatement()) >= 0))
-		return SYMBOL + getStatement()->print(fullBracket);
-	else
-		return QString("%1(%2)")
-		    .arg(SYMBOL, getStatement()->print(fullBracket));
-}
-
-bool UnaryOpStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getStatement() ==
-	           *dynamic_cast<UnaryOpStatement &>(other).getStatement();
-}
-
 UnaryOpStatement::~UnaryOpStatement()
 {
-	delete getStatement();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-UnaryOpStatement::getStringMapping(bool fullBracket)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Symbols are needed anyway */
-	mapping.append(QPair<QString, LogicStatement *>(symbol(), this));
-
-	/* Bracket Not Needed */
-	if (!fullBracket && (comparePrecedence(this, getStatement()) >= 0))
-		mapping += getStatement()->getStringMapping(fullBracket);
-	/* Brackets Required */
-	else {
-		mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-		mapping += getStatement()->getStringMapping(fullBracket);
-		mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-	}
-
-	return mapping;
+	deleteChild(getStatement());
 }
 
 bool UnaryOpStatement::variableBounded(Variable *boundedVariable)
 {
-	/* Propositional logic operator does nothing, need to check nested statement
-	 */
-	return getStatement()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void UnaryOpStatement::collectFreeVariable(Variable *freeVariable,
                                            QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
+
 	/* Symbols has no effect on free variables */
 	getStatement()->collectFreeVariable(freeVariable, collection);
 }
@@ -724,7 +1561,7 @@ void UnaryOpStatement::rejectionBoundVariables(LogicStatement *rootStatement,
 
 bool UnaryOpStatement::notOccur(Variable *var)
 {
-	return getStatement()->notOccur(var);
+	return !occurs(var);
 }
 
 int UnaryOpStatement::numberOfLeibnizReplacedVariable(
@@ -745,8 +1582,10 @@ void UnaryOpStatement::replaceChildStatement(LogicStatement *oldChildFormula,
 
 	if (childStatement == oldChildFormula)
 		setStatement(newChildFormula);
-	else
+	else {
 		childStatement->replaceChildStatement(oldChildFormula, newChildFormula);
+		childChanged(childStatement);
+	}
 }
 
 void UnaryOpStatement::generateRule(QXmlStreamWriter *out)
@@ -763,48 +1602,35 @@ bool UnaryOpStatement::validFirstOrderStatement()
 
 /* NotStatement Class */
 NotStatement::NotStatement(LogicStatement *statement)
+    : UnaryOpStatement(NOT_SYMBOL)
 {
 	setStatement(statement);
 }
 
-bool NotStatement::isFirstOrderLogic()
-{
-	return getStatement()->isFirstOrderLogic();
-}
-
-Symbol NotStatement::getSymbol()
-{
-	return Symbol::NOT_SYMBOL;
-}
-
 QString NotStatement::symbol()
 {
 	return SYMBOL_NOT;
 }
 
-bool NotStatement::evaluate()
-{
-	return !getStatement()->evaluate();
-}
-
-LogicStatement *NotStatement::clone()
-{
-	return new NotStatement(getStatement()->clone());
-}
-
 QString NotStatement::XmlSymbol()
 {
 	return XML_NOT_TAG;
 }
 
 /* BinaryOpStatement Class (Virtual) */
+BinaryOpStatement::BinaryOpStatement(Symbol symbol) : LogicStatement(symbol)
+{
+}
+
 void BinaryOpStatement::setLeftStatement(LogicStatement *newLeft)
 {
+	invalidateSummary();
 	leftStatement = newLeft;
 }
 
 void BinaryOpStatement::setRightStatement(LogicStatement *newRight)
 {
+	invalidateSummary();
 	rightStatement = newRight;
 }
 
@@ -818,62 +1644,6 @@ LogicStatement *BinaryOpStatement::getRightStatement()
 	return rightStatement;
 }
 
-bool BinaryOpStatement::isFirstOrderLogic()
-{
-	return getLeftStatement()->isFirstOrderLogic() ||
-	       getRightStatement()->isFirstOrderLogic();
-}
-
-QString BinaryOpStatement::print(bool fullBracket)
-{
-	QString left;
-	QString right;
-
-	if (!fullBracket && (comparePrecedence(this, getLeftStatement()) >= 0)) {
-		left = getLeftStatement()->print(fullBracket) + QString(" ");
-	} else {
-		left = QString("(%1) ").arg(getLeftStatement()->print(fullBracket));
-	}
-
-	if (!fullBracket && (comparePrecedence(this, getRightStatement()) > 0)) {
-		right = QString(" ") + getRightStatement()->print(fullBracket);
-	} else {
-		right = QString(" (%1)").arg(getRightStatement()->print(fullBracket));
-	}
-
-	return left + symbol() + right;
-}
-
-void
-BinaryOpStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getLeftStatement()->collectVariables(var_list);
-	getRightStatement()->collectVariables(var_list);
-}
-
-bool BinaryOpStatement::equals(LogicStatement *statement)
-{
-	return statement->getSymbol() == getSymbol() &&
-	       getLeftStatement()->equals(dynamic_cast<BinaryOpStatement *>(
-	           statement)->getLeftStatement()) &&
-	       getRightStatement()->equals(dynamic_cast<BinaryOpStatement *>(
-	           statement)->getRightStatement());
-}
-
-bool BinaryOpStatement::match(LogicStatement *matchingStatement,
-                              EquivalenceUtility *matchingUtility)
-{
-	return getSymbol() == matchingStatement->getSymbol() &&
-	       getLeftStatement()->match(
-	           (dynamic_cast<BinaryOpStatement *>(matchingStatement))
-	               ->getLeftStatement(),
-	           matchingUtility) &&
-	       getRightStatement()->match(
-	           (dynamic_cast<BinaryOpStatement *>(matchingStatement))
-	               ->getRightStatement(),
-	           matchingUtility);
-}
-
 LogicStatement *BinaryOpStatement::replace(IDTable *idTable)
 {
 	setLeftStatement(getLeftStatement()->replace(idTable));
@@ -881,63 +1651,25 @@ LogicStatement *BinaryOpStatement::replace(IDTable *idTable)
 	return this;
 }
 
-bool BinaryOpStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getLeftStatement() ==
-	           *dynamic_cast<BinaryOpStatement &>(other).getLeftStatement() &&
-	       *getRightStatement() ==
-	           *dynamic_cast<BinaryOpStatement &>(other).getRightStatement();
-}
-
 BinaryOpStatement::~BinaryOpStatement()
 {
-	delete getLeftStatement();
-	delete getRightStatement();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-BinaryOpStatement::getStringMapping(bool fullBracket)
-{
-
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Bracket not needed on left */
-	if (!fullBracket && (comparePrecedence(this, getLeftStatement()) >= 0))
-		mapping = getLeftStatement()->getStringMapping(fullBracket);
-	/* Brackets needed on left */
-	else {
-		mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-		mapping += getLeftStatement()->getStringMapping(fullBracket);
-		mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-	}
-
-	mapping.append(QPair<QString, LogicStatement *>(symbol(), this));
-
-	/* Brackets not needed on right */
-	if (!fullBracket && (comparePrecedence(this, getRightStatement()) > 0))
-		mapping += getRightStatement()->getStringMapping(fullBracket);
-	else {
-		mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-		mapping += getRightStatement()->getStringMapping(fullBracket);
-		mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-	}
-
-	return mapping;
+	deleteChild(getLeftStatement());
+	deleteChild(getRightStatement());
 }
 
 bool BinaryOpStatement::variableBounded(Variable *boundedVariable)
 {
-	/* Propositional logic operator has no impact on whether a variable is
-	 * bounded or not. Both sides have to be
-	 * evaluated. */
-	return getLeftStatement()->variableBounded(boundedVariable) &&
-	       getRightStatement()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void BinaryOpStatement::collectFreeVariable(Variable *freeVariable,
                                             QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
+
 	/* Symbols has no effect on free variables, need to collect both side of
 	 * BinaryStatement */
 	getLeftStatement()->collectFreeVariable(freeVariable, collection);
@@ -953,8 +1685,7 @@ void BinaryOpStatement::rejectionBoundVariables(LogicStatement *rootStatement,
 
 bool BinaryOpStatement::notOccur(Variable *var)
 {
-	return getLeftStatement()->notOccur(var) &&
-	       getRightStatement()->notOccur(var);
+	return !occurs(var);
 }
 
 int BinaryOpStatement::numberOfLeibnizReplacedVariable(
@@ -993,6 +1724,8 @@ void BinaryOpStatement::replaceChildStatement(LogicStatement *oldChildFormula,
 	else {
 		leftChild->replaceChildStatement(oldChildFormula, newChildFormula);
 		rightChild->replaceChildStatement(oldChildFormula, newChildFormula);
+		childChanged(leftChild);
+		childChanged(rightChild);
 	}
 }
 
@@ -1012,6 +1745,7 @@ bool BinaryOpStatement::validFirstOrderStatement()
 
 /* AndStatement Class */
 AndStatement::AndStatement(LogicStatement *left, LogicStatement *right)
+    : BinaryOpStatement(AND_SYMBOL)
 {
 	setLeftStatement(left);
 	setRightStatement(right);
@@ -1022,22 +1756,6 @@ QString AndStatement::symbol()
 	return SYMBOL_AND;
 }
 
-Symbol AndStatement::getSymbol()
-{
-	return Symbol::AND_SYMBOL;
-}
-
-bool AndStatement::evaluate()
-{
-	return getLeftStatement()->evaluate() && getRightStatement()->evaluate();
-}
-
-LogicStatement *AndStatement::clone()
-{
-	return new AndStatement(getLeftStatement()->clone(),
-	                        getRightStatement()->clone());
-}
-
 QString AndStatement::XmlSymbol()
 {
 	return XML_AND_TAG;
@@ -1045,6 +1763,7 @@ QString AndStatement::XmlSymbol()
 
 /* OrStatement Class */
 OrStatement::OrStatement(LogicStatement *left, LogicStatement *right)
+    : BinaryOpStatement(OR_SYMBOL)
 {
 	setLeftStatement(left);
 	setRightStatement(right);
@@ -1055,22 +1774,6 @@ QString OrStatement::symbol()
 	return SYMBOL_OR;
 }
 
-Symbol OrStatement::getSymbol()
-{
-	return Symbol::OR_SYMBOL;
-}
-
-bool OrStatement::evaluate()
-{
-	return getLeftStatement()->evaluate() || getRightStatement()->evaluate();
-}
-
-LogicStatement *OrStatement::clone()
-{
-	return new OrStatement(getLeftStatement()->clone(),
-	                       getRightStatement()->clone());
-}
-
 QString OrStatement::XmlSymbol()
 {
 	return XML_OR_TAG;
@@ -1078,6 +1781,7 @@ QString OrStatement::XmlSymbol()
 
 /* IffStatement Class */
 IffStatement::IffStatement(LogicStatement *left, LogicStatement *right)
+    : BinaryOpStatement(IFF_SYMBOL)
 {
 	setLeftStatement(left);
 	setRightStatement(right);
@@ -1088,22 +1792,6 @@ QString IffStatement::symbol()
 	return SYMBOL_IFF;
 }
 
-Symbol IffStatement::getSymbol()
-{
-	return Symbol::IFF_SYMBOL;
-}
-
-bool IffStatement::evaluate()
-{
-	return getLeftStatement()->evaluate() == getRightStatement()->evaluate();
-}
-
-LogicStatement *IffStatement::clone()
-{
-	return new IffStatement(getLeftStatement()->clone(),
-	                        getRightStatement()->clone());
-}
-
 QString IffStatement::XmlSymbol()
 {
 	return XML_IFF_TAG;
@@ -1111,60 +1799,15 @@ QString IffStatement::XmlSymbol()
 
 /* ImpliesStatement Class */
 ImpliesStatement::ImpliesStatement(LogicStatement *left, LogicStatement *right)
+    : BinaryOpStatement(IMPLIES_SYMBOL)
 {
 	setLeftStatement(left);
 	setRightStatement(right);
 }
 
-QString ImpliesStatement::symbol()
-{
-	return SYMBOL_IMPLIES;
-}
-
-Symbol ImpliesStatement::getSymbol()
-{
-	return Symbol::IMPLIES_SYMBOL;
-}
-
-bool ImpliesStatement::evaluate()
-{
-	return (!getLeftStatement()->evaluate() || getRightStatement()->evaluate());
-}
-
-LogicStatement *ImpliesStatement::clone()
-{
-	return new ImpliesStatement(getLeftStatement()->clone(),
-	                            getRightStatement()->clone());
-}
-
-bool ImpliesStatement::match(LogicStatement *matchingStatement,
-                             EquivalenceUtility *matchingUtility)
-{
-	bool matched = BinaryOpStatement::match(matchingStatement, matchingUtility);
-
-	/* has the shape of (x=y) IMPLIES (A IFF B) where x is free  */
-	if (isLeibnizRule()) {
-		/* Confirmed x is free in A and y is free in B and y does not occur in
-		 * A, so the idTable has mapping
-		 * for x,y,A and B */
-		if (matched) {
-			IDTable *idTable = matchingUtility->getIDTable();
-			QString A("A");
-			QString B("B");
-			Variable VAR_A(A);
-			Variable VAR_B(B);
-			LogicStatement *matching_A = idTable->valueOf(&VAR_A);
-			LogicStatement *matching_B = idTable->valueOf(&VAR_B);
-
-			/* When one or more free x gets replaced by y, Leibniz rule matched,
-			 * if none gets replaced or structural
-			 * mismatch, then failed to match leibniz rule */
-			return matching_A->numberOfLeibnizReplacedVariable(
-			           matching_B, matchingUtility) > 0;
-		}
-	}
-
-	return matched;
+QString ImpliesStatement::symbol()
+{
+	return SYMBOL_IMPLIES;
 }
 
 QString ImpliesStatement::XmlSymbol()
@@ -1173,14 +1816,9 @@ QString ImpliesStatement::XmlSymbol()
 }
 
 /* FirstOrderStatement Class */
-bool FirstOrderStatement::isFirstOrderLogic()
-{
-	return true;
-}
-
-bool FirstOrderStatement::evaluate()
+FirstOrderStatement::FirstOrderStatement(Symbol symbol)
+    : LogicStatement(symbol)
 {
-	return false;
 }
 
 FirstOrderStatement::~FirstOrderStatement()
@@ -1190,6 +1828,7 @@ FirstOrderStatement::~FirstOrderStatement()
 /* ForAllStatement Class */
 ForAllStatement::ForAllStatement(Variable *identifier,
                                  LogicStatement *forAllStatement)
+    : FirstOrderStatement(FORALL_SYMBOL)
 {
 	setStatement(forAllStatement);
 	setIdentifier(identifier);
@@ -1197,16 +1836,10 @@ ForAllStatement::ForAllStatement(Variable *identifier,
 
 void ForAllStatement::setIdentifier(Variable *identifier)
 {
+	invalidateSummary();
 	this->identifier = identifier;
 }
 
-QString ForAllStatement::print(bool fullBracket)
-{
-	return QString("%1%2(%3)").arg(SYMBOL_FORALL,
-	                               getQuantifier()->print(fullBracket),
-	                               getStatement()->print(fullBracket));
-}
-
 LogicStatement *ForAllStatement::getStatement()
 {
 	return statement;
@@ -1219,149 +1852,41 @@ Variable *ForAllStatement::getQuantifier()
 
 void ForAllStatement::setStatement(LogicStatement *newstatement)
 {
+	invalidateSummary();
 	statement = newstatement;
 }
 
-Symbol ForAllStatement::getSymbol()
-{
-	return Symbol::FORALL_SYMBOL;
-}
-
 ForAllStatement::~ForAllStatement()
 {
-	delete getQuantifier();
-	delete getStatement();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-ForAllStatement::getStringMapping(bool fullBracket)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Quantifier forall binds the entirestatement */
-	mapping.append(
-	    QPair<QString, LogicStatement *>(QString(SYMBOL_FORALL), this));
-	/* Nullptr because Quantifier alone is meaningless for equivalence */
-	mapping.append(
-	    QPair<QString, LogicStatement *>(getQuantifier()->getName(), nullptr));
-
-	/* Bracket not needed */
-	if (!fullBracket && (comparePrecedence(this, getStatement()) > 0))
-		mapping += getStatement()->getStringMapping(fullBracket);
-	/* Brackets needed */
-	else {
-		mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-		mapping += getStatement()->getStringMapping(fullBracket);
-		mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-	}
-
-	return mapping;
+	deleteChild(getQuantifier());
+	deleteChild(getStatement());
 }
 
 bool ForAllStatement::variableBounded(Variable *boundedVariable)
 {
-	/* If the variable appears in the quantifier, we stop and confirm that the
-	 * variable is bounded. */
-	if (getQuantifier()->equals(boundedVariable))
-		return true;
-
-	/* Variable didn't appear in quantifier, check the nested statement */
-	return getStatement()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void ForAllStatement::collectFreeVariable(Variable *freeVariable,
                                           QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
+
 	/* If not bounded by quantifier, then item might be free in nested
 	 * statement, else stop */
 	if (!getQuantifier()->equals(freeVariable))
 		getStatement()->collectFreeVariable(freeVariable, collection);
 }
 
-void ForAllStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getQuantifier()->collectVariables(var_list);
-	getStatement()->collectVariables(var_list);
-}
-
-bool ForAllStatement::equals(LogicStatement *other)
-{
-	return getSymbol() == other->getSymbol() &&
-	       getQuantifier()->equals(
-	           dynamic_cast<ForAllStatement *>(other)->getQuantifier()) &&
-	       getStatement()->equals(
-	           dynamic_cast<ForAllStatement *>(other)->getStatement());
-}
-
-LogicStatement *ForAllStatement::clone()
-{
-	return new ForAllStatement(
-	    dynamic_cast<Variable *>(getQuantifier()->clone()),
-	    getStatement()->clone());
-}
-
-bool ForAllStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getQuantifier() ==
-	           *dynamic_cast<ForAllStatement &>(other).getQuantifier() &&
-	       *getStatement() ==
-	           *dynamic_cast<ForAllStatement &>(other).getStatement();
-}
-
 void ForAllStatement::rejectionBoundVariables(LogicStatement *rootStatement,
                                               LogicSet *rejectionSet)
 {
 	getStatement()->rejectionBoundVariables(rootStatement, rejectionSet);
 }
 
-bool ForAllStatement::match(LogicStatement *matchingStatement,
-                            EquivalenceUtility *matchingUtility)
-{
-	if (getSymbol() != matchingStatement->getSymbol())
-		return false;
-
-	ForAllStatement *castedMatchingStatement =
-	    dynamic_cast<ForAllStatement *>(matchingStatement);
-	Variable *loggedBoundVariable = matchingUtility->getBoundVariable();
-
-	/* In case where the bound variable has been logged for candidate search an
-	 * Example would be
-	 * FORALL(x)(A V B)=A V FORALL(x)(B) where x occurs free in A, in the latter
-	 * rule, the A will be matched and
-	 * candidates for x would be logged, and the second half must confirm one of
-	 * the logged candidates for x is
-	 * the current one it is matching onto */
-	if (loggedBoundVariable != nullptr &&
-	    loggedBoundVariable->equals(getQuantifier())) {
-		/* Current quantifier in actual statement is not matched to any
-		 * candidate */
-		if (matchingUtility->inRejectionBoundVariableSet(
-		        castedMatchingStatement->getQuantifier()))
-			return false;
-
-		/* When control reaches this block, the binding has been confirmed and
-		 * candidate set is no longer needed,
-		 * in fact keeping the information would confuse the matching system */
-		matchingUtility->deleteAuxiliaryItems();
-		matchingUtility->resetAuxiliaryItems();
-		/* Used for renaming bound variables, inserting the x in FORALL(x)A to
-		 * the free list to be replaced later on */
-	} else if (getStatement()->getSymbol() == VARIABLE_SYMBOL &&
-	           dynamic_cast<Variable *>(getStatement())->getFreeVariable() !=
-	               nullptr) {
-		matchingUtility->initFreeVariableList();
-		matchingUtility->getFreeVariableList()->append(
-		    castedMatchingStatement->getQuantifier());
-	}
-
-	/* We proceed adding the quantifier to IDTable as usual and keep matching */
-	return getQuantifier()->match(castedMatchingStatement->getQuantifier(),
-	                              matchingUtility) &&
-	       getStatement()->match(castedMatchingStatement->getStatement(),
-	                             matchingUtility);
-}
-
 LogicStatement *ForAllStatement::replace(IDTable *idTable)
 {
 	setIdentifier(dynamic_cast<Variable *>(getQuantifier()->replace(idTable)));
@@ -1371,7 +1896,7 @@ LogicStatement *ForAllStatement::replace(IDTable *idTable)
 
 bool ForAllStatement::notOccur(Variable *var)
 {
-	return getQuantifier()->notOccur(var) && getStatement()->notOccur(var);
+	return !occurs(var);
 }
 
 int ForAllStatement::numberOfLeibnizReplacedVariable(
@@ -1404,8 +1929,10 @@ void ForAllStatement::replaceChildStatement(LogicStatement *oldChildFormula,
 
 	if (child == oldChildFormula)
 		setStatement(newChildFormula);
-	else
+	else {
 		child->replaceChildStatement(oldChildFormula, newChildFormula);
+		childChanged(child);
+	}
 }
 
 QString ForAllStatement::XmlSymbol()
@@ -1429,6 +1956,7 @@ bool ForAllStatement::validFirstOrderStatement()
 /* ThereExistsStatement Class */
 ThereExistsStatement::ThereExistsStatement(Variable *identifier,
                                            LogicStatement *thereExistsStatement)
+    : FirstOrderStatement(THEREEXISTS_SYMBOL)
 {
 	setStatement(thereExistsStatement);
 	setIdentifier(identifier);
@@ -1436,16 +1964,10 @@ ThereExistsStatement::ThereExistsStatement(Variable *identifier,
 
 void ThereExistsStatement::setIdentifier(Variable *identifier)
 {
+	invalidateSummary();
 	this->identifier = identifier;
 }
 
-QString ThereExistsStatement::print(bool fullBracket)
-{
-	return QString("%1%2(%3)").arg(SYMBOL_THEREEXISTS,
-	                               getQuantifier()->print(fullBracket),
-	                               getStatement()->print(fullBracket));
-}
-
 LogicStatement *ThereExistsStatement::getStatement()
 {
 	return statement;
@@ -1458,97 +1980,35 @@ Variable *ThereExistsStatement::getQuantifier()
 
 void ThereExistsStatement::setStatement(LogicStatement *newStatement)
 {
+	invalidateSummary();
 	statement = newStatement;
 }
 
-Symbol ThereExistsStatement::getSymbol()
-{
-	return Symbol::THEREEXISTS_SYMBOL;
-}
-
 ThereExistsStatement::~ThereExistsStatement()
 {
-	delete getQuantifier();
-	delete getStatement();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-ThereExistsStatement::getStringMapping(bool fullBracket)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Maps symbol thereexists to the entire statement */
-	mapping.append(
-	    QPair<QString, LogicStatement *>(QString(SYMBOL_THEREEXISTS), this));
-	/* Nullptr because quantifier alone is meaningless */
-	mapping.append(
-	    QPair<QString, LogicStatement *>(getQuantifier()->getName(), nullptr));
-
-	/* Bracket Not Needed */
-	if (!fullBracket && (comparePrecedence(this, getStatement()) > 0))
-		mapping += getStatement()->getStringMapping(fullBracket);
-	/* Brackets needed */
-	else {
-		mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-		mapping += getStatement()->getStringMapping(fullBracket);
-		mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-	}
-
-	return mapping;
+	deleteChild(getQuantifier());
+	deleteChild(getStatement());
 }
 
 bool ThereExistsStatement::variableBounded(Variable *boundedVariable)
 {
-	/* If the variable appears in the quantifier, we stop and confirm that the
-	 * variable is bounded. */
-	if (getQuantifier()->equals(boundedVariable))
-		return true;
-
-	/* Variable didn't appear in quantifier, check the nested statement */
-	return getStatement()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void ThereExistsStatement::collectFreeVariable(Variable *freeVariable,
                                                QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
+
 	/* If not bounded by quantifier, then item might be free in nested
 	 * statement, else stop */
 	if (!getQuantifier()->equals(freeVariable))
 		getStatement()->collectFreeVariable(freeVariable, collection);
 }
 
-void
-ThereExistsStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getQuantifier()->collectVariables(var_list);
-	getStatement()->collectVariables(var_list);
-}
-
-bool ThereExistsStatement::equals(LogicStatement *other)
-{
-	return getSymbol() == other->getSymbol() &&
-	       getQuantifier()->equals(
-	           dynamic_cast<ThereExistsStatement *>(other)->getQuantifier()) &&
-	       getStatement()->equals(
-	           dynamic_cast<ThereExistsStatement *>(other)->getStatement());
-}
-
-LogicStatement *ThereExistsStatement::clone()
-{
-	return new ThereExistsStatement(
-	    dynamic_cast<Variable *>(getQuantifier()->clone()),
-	    getStatement()->clone());
-}
-
-bool ThereExistsStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getQuantifier() ==
-	           *dynamic_cast<ThereExistsStatement &>(other).getQuantifier() &&
-	       *getStatement() ==
-	           *dynamic_cast<ThereExistsStatement &>(other).getStatement();
-}
-
 void
 ThereExistsStatement::rejectionBoundVariables(LogicStatement *rootStatement,
                                               LogicSet *rejectionSet)
@@ -1556,53 +2016,6 @@ ThereExistsStatement::rejectionBoundVariables(LogicStatement *rootStatement,
 	getStatement()->rejectionBoundVariables(rootStatement, rejectionSet);
 }
 
-bool ThereExistsStatement::match(LogicStatement *matchingStatement,
-                                 EquivalenceUtility *matchingUtility)
-{
-	if (getSymbol() != matchingStatement->getSymbol())
-		return false;
-
-	ThereExistsStatement *castedMatchingStatement =
-	    dynamic_cast<ThereExistsStatement *>(matchingStatement);
-	Variable *loggedBoundVariable = matchingUtility->getBoundVariable();
-
-	/* In case where the bound variable has been logged for candidate search an
-	 * Example would be
-	 * THEREEXIST(x)(A ^ B)=A ^ THEREEXIST(x)(B) where x occurs free in A, in
-	 * the latter rule, the A will be matched and
-	 * candidates for x would be logged, and the second half must confirm one of
-	 * the logged candidates for x is
-	 * the current one it is matching onto */
-	if (loggedBoundVariable != nullptr &&
-	    loggedBoundVariable->equals(getQuantifier())) {
-		/* Current quantifier in actual statement is not matched to any
-		 * candidate */
-		if (matchingUtility->inRejectionBoundVariableSet(
-		        castedMatchingStatement->getQuantifier()))
-			return false;
-
-		/* When control reaches this block, the binding has been confirmed and
-		 * candidate set is no longer needed,
-		 * in fact keeping the information would confuse the matching system */
-		matchingUtility->resetAuxiliaryItems();
-
-		/* Used for renaming bound variables, inserting the x in FORALL(x)A to
-		 * the free list to be replaced later on */
-	} else if (getStatement()->getSymbol() == VARIABLE_SYMBOL &&
-	           dynamic_cast<Variable *>(getStatement())->getFreeVariable() !=
-	               nullptr) {
-		matchingUtility->initFreeVariableList();
-		matchingUtility->getFreeVariableList()->append(
-		    castedMatchingStatement->getQuantifier());
-	}
-
-	/* We proceed adding the quantifier to IDTable as usual and keep matching */
-	return getQuantifier()->match(castedMatchingStatement->getQuantifier(),
-	                              matchingUtility) &&
-	       getStatement()->match(castedMatchingStatement->getStatement(),
-	                             matchingUtility);
-}
-
 LogicStatement *ThereExistsStatement::replace(IDTable *idTable)
 {
 	setIdentifier(dynamic_cast<Variable *>(getQuantifier()->replace(idTable)));
@@ -1612,7 +2025,7 @@ LogicStatement *ThereExistsStatement::replace(IDTable *idTable)
 
 bool ThereExistsStatement::notOccur(Variable *var)
 {
-	return getQuantifier()->notOccur(var) && getStatement()->notOccur(var);
+	return !occurs(var);
 }
 
 int ThereExistsStatement::numberOfLeibnizReplacedVariable(
@@ -1647,8 +2060,10 @@ ThereExistsStatement::replaceChildStatement(LogicStatement *oldChildFormula,
 
 	if (child == oldChildFormula)
 		setStatement(newChildFormula);
-	else
+	else {
 		child->replaceChildStatement(oldChildFormula, newChildFormula);
+		childChanged(child);
+	}
 }
 
 QString ThereExistsStatement::XmlSymbol()
@@ -1671,6 +2086,7 @@ bool ThereExistsStatement::validFirstOrderStatement()
 
 /* Parameters Class */
 Parameters::Parameters(Variable *variable, Parameters *remainingParameters)
+    : LogicStatement(PARAMETERS_SYMBOL)
 {
 	setParameter(variable);
 	setRemainingParameters(remainingParameters);
@@ -1681,13 +2097,9 @@ Variable *Parameters::getParameter()
 	return parameter;
 }
 
-bool Parameters::evaluate()
-{
-	return false;
-}
-
 void Parameters::setParameter(Variable *newParameter)
 {
+	invalidateSummary();
 	parameter = newParameter;
 }
 
@@ -1698,105 +2110,10 @@ Parameters *Parameters::getRemainingParameters()
 
 void Parameters::setRemainingParameters(Parameters *remainingParameters)
 {
+	invalidateSummary();
 	rest = remainingParameters;
 }
 
-bool Parameters::isFirstOrderLogic()
-{
-	return true;
-}
-
-QString Parameters::print(bool fullBracket)
-{
-	QString param = getParameter()->print(fullBracket);
-
-	if (rest != nullptr)
-		return param + QString(", ") +
-		       getRemainingParameters()->print(fullBracket);
-	else
-		return param;
-}
-
-Symbol Parameters::getSymbol()
-{
-	return Symbol::PARAMETERS_SYMBOL;
-}
-
-void Parameters::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getParameter()->collectVariables(var_list);
-
-	Parameters *remainingParams = getRemainingParameters();
-
-	if (remainingParams != nullptr)
-		remainingParams->collectVariables(var_list);
-}
-
-bool Parameters::equals(LogicStatement *statement)
-{
-
-	if (getSymbol() == statement->getSymbol()) {
-
-		Parameters *casted_statement = dynamic_cast<Parameters *>(statement);
-
-		if (getParameter()->equals(casted_statement->getParameter())) {
-			Parameters *casted_statement_params =
-			    casted_statement->getRemainingParameters();
-			Parameters *current_statement_params = getRemainingParameters();
-
-			if (casted_statement_params == nullptr &&
-			    current_statement_params == nullptr)
-				return true;
-			else if (casted_statement_params == nullptr ||
-			         current_statement_params == nullptr)
-				return false;
-			else
-				return current_statement_params->equals(
-				    casted_statement_params);
-		}
-	}
-
-	return false;
-}
-
-bool Parameters::match(LogicStatement *matchingStatement,
-                       EquivalenceUtility *matchingUtility)
-{
-	if (getSymbol() != matchingStatement->getSymbol())
-		return false;
-
-	Parameters *castedMatchingStatement =
-	    dynamic_cast<Parameters *>(matchingStatement);
-
-	if (!getParameter()->match(castedMatchingStatement->getParameter(),
-	                           matchingUtility))
-		return false;
-
-	Parameters *castedRemainingParams =
-	    castedMatchingStatement->getRemainingParameters();
-	Parameters *remainingParams = getRemainingParameters();
-
-	if (remainingParams == nullptr && castedRemainingParams == nullptr)
-		return true;
-	else if (remainingParams == nullptr || castedRemainingParams == nullptr)
-		return false;
-	else
-		return remainingParams->match(castedRemainingParams, matchingUtility);
-}
-
-LogicStatement *Parameters::clone()
-{
-	Parameters *newRemainingParameters = nullptr;
-	Parameters *remainingParameters = getRemainingParameters();
-
-	if (remainingParameters != nullptr)
-		newRemainingParameters =
-		    dynamic_cast<Parameters *>(remainingParameters->clone());
-
-	return new Parameters(dynamic_cast<Variable *>(getParameter()->clone()),
-	                      newRemainingParameters);
-}
-
 LogicStatement *Parameters::replace(IDTable *idTable)
 {
 	setParameter(dynamic_cast<Variable *>(getParameter()->replace(idTable)));
@@ -1809,77 +2126,24 @@ LogicStatement *Parameters::replace(IDTable *idTable)
 	return this;
 }
 
-bool Parameters::operator==(LogicStatement &other)
-{
-	/* Must have same symbol and parameter match to proceed */
-	if (!(getSymbol() == other.getSymbol() &&
-	      *getParameter() == *dynamic_cast<Parameters &>(other).getParameter()))
-		return false;
-
-	/* Symbol and type matched */
-	Parameters *otherCasted = &dynamic_cast<Parameters &>(other);
-	Parameters *currentRemainingParams = getRemainingParameters();
-	Parameters *otherRemainingParams = otherCasted->getRemainingParameters();
-
-	/* No more parameters */
-	if (currentRemainingParams == nullptr && otherRemainingParams == nullptr)
-		return true;
-
-	/* One has more parameter whilst other one doesn't */
-	if (currentRemainingParams == nullptr || otherRemainingParams == nullptr)
-		return false;
-
-	/* Both has more parameters needs to be matched */
-	return *currentRemainingParams == *otherRemainingParams;
-}
-
 Parameters::~Parameters()
 {
-	delete getParameter();
-	Parameters *remainingParameters = getRemainingParameters();
-	if (remainingParameters != nullptr)
-		delete remainingParameters;
-}
-
-QVector<QPair<QString, LogicStatement *> >
-Parameters::getStringMapping(bool fullBracket)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Null Pointer here because one argument is meaningless alone */
-	mapping.append(
-	    QPair<QString, LogicStatement *>(getParameter()->getName(), nullptr));
-	Parameters *remainingParameters = getRemainingParameters();
-
-	if (remainingParameters != nullptr) {
-		mapping.append(QPair<QString, LogicStatement *>(",", nullptr));
-		mapping += remainingParameters->getStringMapping(fullBracket);
-	}
-
-	return mapping;
+	deleteChild(getParameter());
+	deleteChild(getRemainingParameters());
 }
 
 bool Parameters::variableBounded(Variable *boundedVariable)
 {
-	/* We reached this block of code because variable is not caught in
-	 * ThereExists or ForAll, so if boundedVariable
-	 * appears, we stop and conclude the variable is not bounded */
-	if (getParameter()->equals(boundedVariable))
-		return false;
-
-	Parameters *remainingParams = getRemainingParameters();
-
-	/* The current variable is not bounded, if more variables check. */
-	if (remainingParams != nullptr)
-		return remainingParams->variableBounded(boundedVariable);
-
-	/* No more variables */
-	return true;
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void Parameters::collectFreeVariable(Variable *freeVariable,
                                      QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
 
 	Variable *parameter = getParameter();
 
@@ -1908,15 +2172,7 @@ void Parameters::rejectionBoundVariables(LogicStatement *root,
 
 bool Parameters::notOccur(Variable *var)
 {
-	if (!getParameter()->notOccur(var))
-		return false;
-
-	Parameters *remainingParams = getRemainingParameters();
-
-	if (remainingParams != nullptr)
-		return remainingParams->notOccur(var);
-
-	return true;
+	return !occurs(var);
 }
 
 int
@@ -1979,6 +2235,7 @@ bool Parameters::validFirstOrderStatement()
 /* PredicateSymbolStatement Class */
 PredicateSymbolStatement::PredicateSymbolStatement(Variable *predicateName,
                                                    Parameters *params)
+    : FirstOrderStatement(PREDICATE_SYMBOL)
 {
 	setPredicateSymbol(predicateName);
 	setParameters(params);
@@ -1996,6 +2253,7 @@ Variable *PredicateSymbolStatement::getPredicateSymbol()
 
 void PredicateSymbolStatement::setPredicateSymbol(Variable *predicateName)
 {
+	invalidateSummary();
 	predicateSymbol = predicateName;
 }
 
@@ -2006,106 +2264,40 @@ Parameters *PredicateSymbolStatement::getParameters()
 
 void PredicateSymbolStatement::setParameters(Parameters *params)
 {
+	invalidateSummary();
 	parameters = params;
 }
 
-QString PredicateSymbolStatement::print(bool fullBracket)
-{
-	return QString("%1(%2)")
-	    .arg(getPredicateSymbolName(), getParameters()->print(fullBracket));
-}
-
-Symbol PredicateSymbolStatement::getSymbol()
-{
-	return Symbol::PREDICATE_SYMBOL;
-}
-
 PredicateSymbolStatement::~PredicateSymbolStatement()
 {
-	delete getPredicateSymbol();
-	delete getParameters();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-PredicateSymbolStatement::getStringMapping(bool fullBracket)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	mapping.append(
-	    QPair<QString, LogicStatement *>(getPredicateSymbolName(), this));
-	mapping.append(QPair<QString, LogicStatement *>("(", nullptr));
-	mapping += getParameters()->getStringMapping(fullBracket);
-	mapping.append(QPair<QString, LogicStatement *>(")", nullptr));
-
-	return mapping;
+	deleteChild(getPredicateSymbol());
+	deleteChild(getParameters());
 }
 
 bool PredicateSymbolStatement::variableBounded(Variable *boundedVariable)
 {
-	/* In the context of  */
-	return getParameters()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void
 PredicateSymbolStatement::collectFreeVariable(Variable *freeVariable,
                                               QVector<Variable *> *collection)
 {
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
+
 	/* No need to check function symbol name */
 	getParameters()->collectFreeVariable(freeVariable, collection);
 }
 
-void PredicateSymbolStatement::collectVariables(
-    QVector<QVector<Variable *> *> *var_list)
-{
-	getPredicateSymbol()->collectVariables(var_list);
-	getParameters()->collectVariables(var_list);
-}
-
-bool PredicateSymbolStatement::equals(LogicStatement *other)
-{
-	return getSymbol() == other->getSymbol() &&
-	       getPredicateSymbol()->equals(
-	           dynamic_cast<PredicateSymbolStatement *>(other)
-	               ->getPredicateSymbol()) &&
-	       getParameters()->equals(dynamic_cast<PredicateSymbolStatement *>(
-	           other)->getParameters());
-}
-
-LogicStatement *PredicateSymbolStatement::clone()
-{
-	return new PredicateSymbolStatement(
-	    dynamic_cast<Variable *>(getPredicateSymbol()->clone()),
-	    dynamic_cast<Parameters *>(getParameters()->clone()));
-}
-
-bool PredicateSymbolStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getPredicateSymbol() == *dynamic_cast<PredicateSymbolStatement &>(
-	                                     other).getPredicateSymbol() &&
-	       *getParameters() ==
-	           *dynamic_cast<PredicateSymbolStatement &>(other).getParameters();
-}
-
 void PredicateSymbolStatement::rejectionBoundVariables(LogicStatement *root,
                                                        LogicSet *rejectionSet)
 {
 	getParameters()->rejectionBoundVariables(root, rejectionSet);
 }
 
-bool PredicateSymbolStatement::match(LogicStatement *matchingStatement,
-                                     EquivalenceUtility *matchingUtility)
-{
-	return getSymbol() == matchingStatement->getSymbol() &&
-	       getPredicateSymbol()->match(
-	           dynamic_cast<PredicateSymbolStatement *>(matchingStatement)
-	               ->getPredicateSymbol(),
-	           matchingUtility) &&
-	       getParameters()->match(dynamic_cast<PredicateSymbolStatement *>(
-	                                  matchingStatement)->getParameters(),
-	                              matchingUtility);
-}
-
 LogicStatement *PredicateSymbolStatement::replace(IDTable *idTable)
 {
 	/* Predicate Symbol (function symbol) should not be replaced in any instance
@@ -2117,8 +2309,7 @@ LogicStatement *PredicateSymbolStatement::replace(IDTable *idTable)
 
 bool PredicateSymbolStatement::notOccur(Variable *var)
 {
-	return getPredicateSymbol()->notOccur(var) &&
-	       getParameters()->notOccur(var);
+	return !occurs(var);
 }
 
 int PredicateSymbolStatement::numberOfLeibnizReplacedVariable(
@@ -2168,6 +2359,7 @@ bool PredicateSymbolStatement::validFirstOrderStatement()
 
 /* EqualityStatement Class */
 EqualityStatement::EqualityStatement(Variable *left, Variable *right)
+    : FirstOrderStatement(EQUALS_SYMBOL)
 {
 	setLeftVariable(left);
 	setRightVariable(right);
@@ -2185,92 +2377,36 @@ Variable *EqualityStatement::getRightVariable()
 
 void EqualityStatement::setLeftVariable(Variable *newLeft)
 {
+	invalidateSummary();
 	leftVariable = newLeft;
 }
 
 void EqualityStatement::setRightVariable(Variable *newRight)
 {
+	invalidateSummary();
 	rightVariable = newRight;
 }
 
-QString EqualityStatement::print(bool fullBracket)
-{
-	return getLeftVariable()->print(fullBracket) + QString(" ") +
-	       QString(SYMBOL_EQUALS) + QString(" ") +
-	       getRightVariable()->print(fullBracket);
-}
-
-Symbol EqualityStatement::getSymbol()
-{
-	return Symbol::EQUALS_SYMBOL;
-}
-
 EqualityStatement::~EqualityStatement()
 {
-	delete getLeftVariable();
-	delete getRightVariable();
-}
-
-QVector<QPair<QString, LogicStatement *> >
-EqualityStatement::getStringMapping(bool)
-{
-	QVector<QPair<QString, LogicStatement *> > mapping;
-
-	/* Null Mapping because one Variable argument is meaningless for equivalence
-	 */
-	mapping.append(QPair<QString, LogicStatement *>(
-	    getLeftVariable()->getName(), nullptr));
-	mapping.append(
-	    QPair<QString, LogicStatement *>(QString(SYMBOL_EQUALS), this));
-	mapping.append(QPair<QString, LogicStatement *>(
-	    getRightVariable()->getName(), nullptr));
-
-	return mapping;
+	deleteChild(getLeftVariable());
+	deleteChild(getRightVariable());
 }
 
 bool EqualityStatement::variableBounded(Variable *boundedVariable)
 {
-	/* Need to check both left and right of "=" for bounded variable */
-	return getLeftVariable()->variableBounded(boundedVariable) &&
-	       getRightVariable()->variableBounded(boundedVariable);
+	/* Bounded means not free anywhere in the statement */
+	return !occursFree(boundedVariable);
 }
 
 void EqualityStatement::collectFreeVariable(Variable *freeVariable,
                                             QVector<Variable *> *collection)
 {
-	getLeftVariable()->collectFreeVariable(freeVariable, collection);
-}
-
-void
-EqualityStatement::collectVariables(QVector<QVector<Variable *> *> *var_list)
-{
-	getLeftVariable()->collectVariables(var_list);
-	getRightVariable()->collectVariables(var_list);
-}
-
-bool EqualityStatement::equals(LogicStatement *other)
-{
-	return getSymbol() == other->getSymbol() &&
-	       getLeftVariable()->equals(
-	           dynamic_cast<EqualityStatement *>(other)->getLeftVariable()) &&
-	       getRightVariable()->equals(
-	           dynamic_cast<EqualityStatement *>(other)->getRightVariable());
-}
-
-LogicStatement *EqualityStatement::clone()
-{
-	return new EqualityStatement(
-	    dynamic_cast<Variable *>(getLeftVariable()->clone()),
-	    dynamic_cast<Variable *>(getRightVariable()->clone()));
-}
+	/* Nothing to collect below here */
+	if (!occursFree(freeVariable))
+		return;
 
-bool EqualityStatement::operator==(LogicStatement &other)
-{
-	return getSymbol() == other.getSymbol() &&
-	       *getLeftVariable() ==
-	           *dynamic_cast<EqualityStatement &>(other).getLeftVariable() &&
-	       *getRightVariable() ==
-	           *dynamic_cast<EqualityStatement &>(other).getRightVariable();
+	getLeftVariable()->collectFreeVariable(freeVariable, collection);
 }
 
 void EqualityStatement::rejectionBoundVariables(LogicStatement *root,
@@ -2280,18 +2416,6 @@ void EqualityStatement::rejectionBoundVariables(LogicStatement *root,
 	getRightVariable()->rejectionBoundVariables(root, rejectionSet);
 }
 
-bool EqualityStatement::match(LogicStatement *matchingStatement,
-                              EquivalenceUtility *matchingUtility)
-{
-	return getSymbol() == matchingStatement->getSymbol() &&
-	       getLeftVariable()->match(dynamic_cast<EqualityStatement *>(
-	                                    matchingStatement)->getLeftVariable(),
-	                                matchingUtility) &&
-	       getRightVariable()->match(dynamic_cast<EqualityStatement *>(
-	                                     matchingStatement)->getRightVariable(),
-	                                 matchingUtility);
-}
-
 LogicStatement *EqualityStatement::replace(IDTable *idTable)
 {
 	setLeftVariable(
@@ -2303,8 +2427,7 @@ LogicStatement *EqualityStatement::replace(IDTable *idTable)
 
 bool EqualityStatement::notOccur(Variable *var)
 {
-	return getLeftVariable()->notOccur(var) &&
-	       getRightVariable()->notOccur(var);
+	return !occurs(var);
 }
 
 int EqualityStatement::numberOfLeibnizReplacedVariable(
@@ -2355,27 +2478,14 @@ bool EqualityStatement::validFirstOrderStatement()
 	return true;
 }
 
-extern int yyparse();
-
 /**
  * @brief Parse the string to generate AST
  * @param expression String to parse
  * @return Well-formed AST if expression is well-formed
- *         otherwise return NULL
+ *         otherwise return NULL, parse with a FormulaParser to learn why
  */
 LogicStatement *AST::parse(QString expression)
 {
-	yy_scan_string(expression.toUtf8().constData());
-	int result = yyparse();
-	if (result != 0)
-		return nullptr;
-	else {
-		if (entireStatement->isFirstOrderLogic() &&
-		    !entireStatement->validFirstOrderStatement()) {
-			delete entireStatement;
-			return nullptr;
-		}
-
-		return entireStatement;
-	}
+	FormulaParser parser;
+	return parser.parse(expression);
 }
@@ -2,6 +2,8 @@
 #define AST_HPP
 
 #include "symbol.hpp"
+#include <QHash>
+#include <QMap>
 #include <QString>
 #include <QVector>
 #include <QPair>
@@ -12,6 +14,7 @@ class LogicSet;
 
 class EquivalenceUtility;
 class IDTable;
+class FormulaPath;
 
 namespace AST
 {
@@ -27,28 +30,90 @@ class LogicStatement
 	 * rule is Leibniz rule */
 	bool isLeibniz = false;
 
+	/* Kept in the node so dispatching on it costs no virtual call, see
+	 * StatementVisitor */
+	Symbol concreteSymbol;
+
+	/* Facts about a subtree that matching asks for over and over */
+	struct Summary
+	{
+		uint hash;
+		int size;
+		int depth;
+		/* Sorted SymbolTable ids. A subtree holds few variables while ids
+		 * grow with every name ever interned, so the sets are kept as short
+		 * lists, shared with a child whenever they equal its own */
+		QVector<quint32> freeVariables;
+		QVector<quint32> occurringVariables;
+	};
+
+	/* Computed on first use, see invalidateSummary */
+	Summary *summary = nullptr;
+
+	Summary *getSummary();
+	/* Summarises this node from the current summaries of its children */
+	void summarise();
+
+	/* FormulaPath invalidates the nodes along the path it rewrites */
+	friend class ::FormulaPath;
+
+  protected:
+	/* Concrete classes pass the symbol representing them */
+	explicit LogicStatement(Symbol symbol);
+
+	/* Frees a child from a destructor. A deletion started inside another
+	 * one is queued and run by the outermost, so deleting a statement takes
+	 * constant native stack whatever its depth */
+	static void deleteChild(LogicStatement *child);
+
+	/* Called by every setter replacing a child or a name, drops the summary
+	 * of this node. Nodes do not know their parents, so whoever changes a
+	 * node below a summarised one invalidates every node on the way down:
+	 * replaceChildStatement and FormulaPath::replace as they descend, and
+	 * replace(IDTable *) through the setters of every node it rebuilds */
+	void invalidateSummary();
+
+	/* Called after something below child may have changed, invalidates
+	 * this node when child lost its summary. Ancestors are summarised after
+	 * their descendants, so a child without one means nothing is cached
+	 * here that could still be right */
+	void childChanged(LogicStatement *child);
+
   public:
 	/* Returns a QString representation of AST */
-	virtual QString print(bool fullBracket) = 0;
+	QString print(bool fullBracket);
+
+	/* Appends the representation of AST to out in one pass. When spans is
+	 * given it receives the start and length in out of the representation
+	 * of every subformula, which is what print would return for it */
+	void print(bool fullBracket, QString *out,
+	           QHash<LogicStatement *, QPair<int, int> > *spans = nullptr);
 
 	/* Checks whether an AST contains first order logic */
-	virtual bool isFirstOrderLogic() = 0;
+	bool isFirstOrderLogic();
 
 	/* Returns the symbol representing a concrete class */
-	virtual Symbol getSymbol() = 0;
+	Symbol getSymbol();
+
+	/* Negative when inner binds more loosely than outer and so needs
+	 * brackets around it */
+	static inline int comparePrecedence(LogicStatement *outer,
+	                                    LogicStatement *inner);
 
 	/* Returns a boolean value of the AST when variables
 	 * gets assigned their boolean values */
-	virtual bool evaluate() = 0;
+	bool evaluate();
 
 	/* Used to check whether start and end formula is
-	 * logically equivalent */
-	bool isEquivalent(LogicStatement *);
+	 * logically equivalent, when they are not and counterexample is
+	 * given it receives an assignment telling them apart */
+	bool isEquivalent(LogicStatement *,
+	                  QMap<QString, bool> *counterexample = nullptr);
 
 	/* Iterates through the AST collecting references of
 	 * variables, the inner vector represents a list with
 	 * all variables having the same name */
-	virtual void collectVariables(QVector<QVector<Variable *> *> *) = 0;
+	void collectVariables(QVector<QVector<Variable *> *> *);
 
 	/* Free up memory used to check start formula is
 	 * equivalent to end one */
@@ -56,12 +121,12 @@ class LogicStatement
 
 	/* Checks whether two AST are identical in structure
 	 * and name */
-	virtual bool equals(LogicStatement *) = 0;
+	bool equals(LogicStatement *);
 
 	/* Called by rule AST to match the actual user AST
 	 * called matching_statement */
-	virtual bool match(LogicStatement *matchingStatement,
-	                   EquivalenceUtility *matchingUtility) = 0;
+	bool match(LogicStatement *matchingStatement,
+	           EquivalenceUtility *matchingUtility);
 
 	/* Called from the replace rule, creates identical copies on heap with
 	 * variables cloned using id_table,
@@ -70,17 +135,25 @@ class LogicStatement
 	virtual LogicStatement *replace(IDTable *idTable) = 0;
 
 	/* A function that deep clones a logicstatement */
-	virtual LogicStatement *clone() = 0;
+	LogicStatement *clone();
 
 	/* Overriding == so that it can be used in standard container library */
-	virtual bool operator==(LogicStatement &other) = 0;
+	bool operator==(LogicStatement &other);
 
 	/* Main parent destructor */
 	virtual ~LogicStatement();
 
+	/* Nodes are placed in the current arena when there is one */
+	static void *operator new(size_t size);
+	static void operator delete(void *memory);
+
 	/* Mapping from broken parts of print to its corresponding LogicStatement */
-	virtual QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) = 0;
+	QVector<QPair<QString, LogicStatement *> >
+	getStringMapping(bool fullBracket);
+
+	/* Appends the mapping to mapping in one pass */
+	void getStringMapping(bool fullBracket,
+	                      QVector<QPair<QString, LogicStatement *> > *mapping);
 
 	/* Returns true if the variable parameter is bounded, i.e. ForAll
 	 * boundedVariable,
@@ -117,6 +190,29 @@ class LogicStatement
 	/* Returns true iff var does not appear in the statement at all */
 	virtual bool notOccur(Variable *var) = 0;
 
+	/* Constant time once the statement has been summarised: whether var
+	 * occurs free, whether it occurs at all, a hash that is equal for
+	 * equal statements, the number of nodes and the depth */
+	bool occursFree(Variable *var);
+	bool occurs(Variable *var);
+	uint structuralHash();
+	int nodeCount();
+	int depth();
+
+	/* Drops the summaries of every node, for after variables below have
+	 * been renamed in place */
+	void invalidateSummaries();
+
+	/* Children in the order they are printed, nullptr past the last one:
+	 * operands of connectives, quantified variable and body of quantifiers,
+	 * predicate symbol and parameter list of predicates, first parameter
+	 * and the rest of a parameter list, both sides of an equality */
+	LogicStatement *getChild(int index);
+	int childCount();
+
+	/* Both children at once, as getChild(0) and getChild(1) */
+	void getChildren(LogicStatement *children[2]);
+
 	/* Every symbol must match and where a variable is logged to be occur free
 	 * in one logicstatement, it occurs free
 	 * at the same position in the other logicstatement with either it been the
@@ -142,27 +238,13 @@ class LogicStatement
 	virtual QString XmlSymbol() = 0;
 
 	virtual bool validFirstOrderStatement() = 0;
-
-  protected:
-	static inline int comparePrecedence(LogicStatement *outer,
-	                                    LogicStatement *inner);
 };
 
 class Truth : public LogicStatement
 {
   public:
-	QString print(bool) override;
-	bool isFirstOrderLogic() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *) override;
+	Truth();
 	LogicStatement *replace(IDTable *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
-	QVector<QPair<QString, LogicStatement *> > getStringMapping(bool) override;
 	bool variableBounded(Variable *) override;
 	void collectFreeVariable(Variable *, QVector<Variable *> *) override;
 	void rejectionBoundVariables(LogicStatement *, LogicSet *) override;
@@ -178,18 +260,8 @@ class Truth : public LogicStatement
 class Falsity : public LogicStatement
 {
   public:
-	QString print(bool) override;
-	bool isFirstOrderLogic() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *) override;
+	Falsity();
 	LogicStatement *replace(IDTable *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
-	QVector<QPair<QString, LogicStatement *> > getStringMapping(bool) override;
 	bool variableBounded(Variable *) override;
 	void collectFreeVariable(Variable *, QVector<Variable *> *) override;
 	void rejectionBoundVariables(LogicStatement *, LogicSet *) override;
@@ -204,7 +276,8 @@ class Falsity : public LogicStatement
 
 class Variable : public LogicStatement
 {
-	QString name;
+	/* Id of the name in the global SymbolTable */
+	quint32 id;
 	bool value;
 	/* Used by rule to indicate variable that binds to logicstatement */
 	Variable *freeVariable;
@@ -217,27 +290,19 @@ class Variable : public LogicStatement
 
   public:
 	Variable(QString &name);
+	explicit Variable(quint32 id);
 	~Variable();
 	void setName(QString);
-	QString print(bool) override;
-	QString &getName();
-	bool isFirstOrderLogic() override;
-	Symbol getSymbol() override;
+	const QString &getName();
+	quint32 getId();
 
 	/* Used to give variable a boolean value */
 	void setBooleanValue(bool);
-	bool evaluate() override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
+	bool getBooleanValue();
 	/* Called from cloned version of rule, delete this removes the cloned
 	 * version which is no longer accessible
 	 * because it gets replaced */
 	LogicStatement *replace(IDTable *idTable) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
-	QVector<QPair<QString, LogicStatement *> > getStringMapping(bool) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
@@ -264,26 +329,18 @@ class UnaryOpStatement : public LogicStatement
 {
 	LogicStatement *nestedStatement;
 
+	/* FormulaPath rewrites children in place through the setters */
+	friend class ::FormulaPath;
+
   protected:
+	explicit UnaryOpStatement(Symbol symbol);
 	void setStatement(LogicStatement *);
 
   public:
-	QString print(bool) override;
-	virtual bool isFirstOrderLogic() = 0;
 	LogicStatement *getStatement();
-	virtual Symbol getSymbol() = 0;
 	virtual QString symbol() = 0;
-	bool evaluate() = 0;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
-	virtual LogicStatement *clone() = 0;
-	bool operator==(LogicStatement &) override;
 	virtual ~UnaryOpStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
@@ -303,11 +360,7 @@ class NotStatement : public UnaryOpStatement
 {
   public:
 	NotStatement(LogicStatement *);
-	bool isFirstOrderLogic() override;
-	Symbol getSymbol() override;
 	QString symbol() override;
-	bool evaluate() override;
-	LogicStatement *clone() override;
 	QString XmlSymbol() override;
 };
 
@@ -316,28 +369,19 @@ class BinaryOpStatement : public LogicStatement
 	LogicStatement *leftStatement;
 	LogicStatement *rightStatement;
 
+	friend class ::FormulaPath;
+
   protected:
+	explicit BinaryOpStatement(Symbol symbol);
 	void setLeftStatement(LogicStatement *);
 	void setRightStatement(LogicStatement *);
 
   public:
 	virtual QString symbol() = 0;
-	bool isFirstOrderLogic() override;
-	QString print(bool) override;
 	LogicStatement *getLeftStatement();
 	LogicStatement *getRightStatement();
-	Symbol getSymbol() = 0;
-	bool evaluate() = 0;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	virtual bool match(LogicStatement *matchingStatement,
-	                   EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
-	virtual LogicStatement *clone() = 0;
-	bool operator==(LogicStatement &) override;
 	virtual ~BinaryOpStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
@@ -358,9 +402,6 @@ class AndStatement : public BinaryOpStatement
   public:
 	AndStatement(LogicStatement *, LogicStatement *);
 	QString symbol() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	LogicStatement *clone() override;
 	QString XmlSymbol() override;
 };
 
@@ -369,9 +410,6 @@ class OrStatement : public BinaryOpStatement
   public:
 	OrStatement(LogicStatement *, LogicStatement *);
 	QString symbol() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	LogicStatement *clone() override;
 	QString XmlSymbol() override;
 };
 
@@ -380,9 +418,6 @@ class IffStatement : public BinaryOpStatement
   public:
 	IffStatement(LogicStatement *, LogicStatement *);
 	QString symbol() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	LogicStatement *clone() override;
 	QString XmlSymbol() override;
 };
 
@@ -391,31 +426,17 @@ class ImpliesStatement : public BinaryOpStatement
   public:
 	ImpliesStatement(LogicStatement *, LogicStatement *);
 	QString symbol() override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	LogicStatement *clone() override;
-	/* Added just for Leibniz Rule */
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	QString XmlSymbol() override;
 };
 
 class FirstOrderStatement : public LogicStatement
 {
+  protected:
+	explicit FirstOrderStatement(Symbol symbol);
+
   public:
-	virtual QString print(bool) = 0;
-	bool isFirstOrderLogic() override;
-	virtual Symbol getSymbol() = 0;
-	bool evaluate() override;
-	virtual void collectVariables(QVector<QVector<Variable *> *> *) = 0;
-	virtual bool equals(LogicStatement *) = 0;
-	virtual bool match(LogicStatement *, EquivalenceUtility *) = 0;
-	virtual LogicStatement *clone() = 0;
 	virtual LogicStatement *replace(IDTable *) = 0;
-	virtual bool operator==(LogicStatement &) = 0;
 	virtual ~FirstOrderStatement();
-	virtual QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool) = 0;
 	virtual bool variableBounded(Variable *) = 0;
 	virtual void collectFreeVariable(Variable *, QVector<Variable *> *) = 0;
 	virtual bool notOccur(Variable *) = 0;
@@ -432,30 +453,22 @@ class ForAllStatement : public FirstOrderStatement
 	LogicStatement *statement;
 	Variable *identifier;
 
+	friend class ::FormulaPath;
+
   protected:
 	void setStatement(LogicStatement *);
 	void setIdentifier(Variable *);
 
   public:
 	ForAllStatement(Variable *, LogicStatement *);
-	QString print(bool) override;
 	LogicStatement *getStatement();
 	Variable *getQuantifier();
-	Symbol getSymbol() override;
 	~ForAllStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
 	void rejectionBoundVariables(LogicStatement *rootStatement,
 	                             LogicSet *rejectionSet) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
 	bool notOccur(Variable *var) override;
 	int numberOfLeibnizReplacedVariable(
@@ -472,30 +485,22 @@ class ThereExistsStatement : public FirstOrderStatement
 	LogicStatement *statement;
 	Variable *identifier;
 
+	friend class ::FormulaPath;
+
   protected:
 	void setStatement(LogicStatement *);
 	void setIdentifier(Variable *);
 
   public:
 	ThereExistsStatement(Variable *, LogicStatement *);
-	QString print(bool) override;
 	LogicStatement *getStatement();
 	Variable *getQuantifier();
-	Symbol getSymbol() override;
 	~ThereExistsStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
 	void rejectionBoundVariables(LogicStatement *rootStatement,
 	                             LogicSet *rejectionSet) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
 	bool notOccur(Variable *var) override;
 	int numberOfLeibnizReplacedVariable(
@@ -512,6 +517,8 @@ class Parameters : public LogicStatement
 	Variable *parameter;
 	Parameters *rest;
 
+	friend class ::FormulaPath;
+
   protected:
 	void setParameter(Variable *);
 	void setRemainingParameters(Parameters *);
@@ -520,20 +527,8 @@ class Parameters : public LogicStatement
 	Parameters(Variable *, Parameters *);
 	Variable *getParameter();
 	Parameters *getRemainingParameters();
-	bool isFirstOrderLogic() override;
-	QString print(bool) override;
-	Symbol getSymbol() override;
-	bool evaluate() override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
-	LogicStatement *clone() override;
 	LogicStatement *replace(IDTable *idTable) override;
-	bool operator==(LogicStatement &) override;
 	~Parameters();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
@@ -552,6 +547,9 @@ class PredicateSymbolStatement : public FirstOrderStatement
 {
 	Variable *predicateSymbol;
 	Parameters *parameters;
+
+	friend class ::FormulaPath;
+
 	void setParameters(Parameters *);
 	void setPredicateSymbol(Variable *);
 
@@ -560,22 +558,12 @@ class PredicateSymbolStatement : public FirstOrderStatement
 	QString getPredicateSymbolName();
 	Variable *getPredicateSymbol();
 	Parameters *getParameters();
-	QString print(bool) override;
-	Symbol getSymbol() override;
 	~PredicateSymbolStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
-	void collectVariables(QVector<QVector<Variable *> *> *) override;
-	bool equals(LogicStatement *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
 	void rejectionBoundVariables(LogicStatement *root,
 	                             LogicSet *rejectionSet) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
 	bool notOccur(Variable *var) override;
 	int numberOfLeibnizReplacedVariable(
@@ -590,6 +578,9 @@ class EqualityStatement : public FirstOrderStatement
 {
 	Variable *leftVariable;
 	Variable *rightVariable;
+
+	friend class ::FormulaPath;
+
 	void setLeftVariable(Variable *);
 	void setRightVariable(Variable *);
 
@@ -597,22 +588,12 @@ class EqualityStatement : public FirstOrderStatement
 	EqualityStatement(Variable *, Variable *);
 	Variable *getLeftVariable();
 	Variable *getRightVariable();
-	QString print(bool fullBracket) override;
-	Symbol getSymbol() override;
 	~EqualityStatement();
-	QVector<QPair<QString, LogicStatement *> >
-	getStringMapping(bool fullBracket) override;
 	bool variableBounded(Variable *boundedVariable) override;
 	void collectFreeVariable(Variable *freeVariable,
 	                         QVector<Variable *> *collection) override;
-	void collectVariables(QVector<QVector<Variable *> *> *collection) override;
-	bool equals(LogicStatement *) override;
-	LogicStatement *clone() override;
-	bool operator==(LogicStatement &) override;
 	void rejectionBoundVariables(LogicStatement *root,
 	                             LogicSet *rejectionSet) override;
-	bool match(LogicStatement *matchingStatement,
-	           EquivalenceUtility *matchingUtility) override;
 	LogicStatement *replace(IDTable *idTable) override;
 	bool notOccur(Variable *var) override;
 	int numberOfLeibnizReplacedVariable(
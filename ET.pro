@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -36,7 +36,23 @@ SOURCES += main.cpp\
     equivalenceutility.cpp \
     matchedruleselectiondialog.cpp \
     ruleengine.cpp \
-    replacementinputdialog.cpp
+    replacementinputdialog.cpp \
+    bitslicedevaluator.cpp \
+    satsolver.cpp \
+    tseitinencoder.cpp \
+    bddmanager.cpp \
+    modelchecker.cpp \
+    formuladag.cpp \
+    arena.cpp \
+    symboltable.cpp \
+    flatformula.cpp \
+    formulapath.cpp \
+    formulaparser.cpp \
+    batchparser.cpp \
+    parsecache.cpp \
+    rulekey.cpp \
+    discriminationtree.cpp \
+    paralleljob.cpp
 
 HEADERS  += mainwindow.hpp \
     newsolutiondialog.hpp \
@@ -57,7 +73,26 @@ HEADERS  += mainwindow.hpp \
     matchedruleselectiondialog.hpp \
     utility.hpp \
     ruleengine.hpp \
-    replacementinputdialog.hpp
+    replacementinputdialog.hpp \
+    bitslicedevaluator.hpp \
+    satsolver.hpp \
+    tseitinencoder.hpp \
+    bddmanager.hpp \
+    modelchecker.hpp \
+    formuladag.hpp \
+    arena.hpp \
+    symboltable.hpp \
+    flatformula.hpp \
+    formulapath.hpp \
+    statementwalker.hpp \
+    statementvisitor.hpp \
+    formulaparser.hpp \
+    batchparser.hpp \
+    parsecache.hpp \
+    rulebundle.hpp \
+    rulekey.hpp \
+    discriminationtree.hpp \
+    paralleljob.hpp
 
 FORMS    += mainwindow.ui \
     newsolutiondialog.ui \
@@ -69,52 +104,18 @@ FORMS    += mainwindow.ui \
     replacementinputdialog.ui \
     formulareplacementdialog.ui
 
-LIBS += -ll -ly
-
-FLEXSOURCES = lexer.l
-BISONSOURCES = parser.y
 EQUIVALENCESOURCES += equivalences.xml
 
 OTHER_FILES +=  \
-    $$FLEXSOURCES \
-    $$BISONSOURCES \
-    $$EQUIVALENCESOURCES
-
-flexsource.input = FLEXSOURCES
-flexsource.output = ${QMAKE_FILE_BASE}.cpp
-flexsource.commands = flex --header-file=${QMAKE_FILE_BASE}.hpp -o ${QMAKE_FILE_BASE}.cpp ${QMAKE_FILE_IN}
-flexsource.variable_out = SOURCES
-flexsource.name = Flex Sources ${QMAKE_FILE_IN}
-flexsource.CONFIG += target_predeps
-
-QMAKE_EXTRA_COMPILERS += flexsource
-
-flexheader.input = FLEXSOURCES
-flexheader.output = ${QMAKE_FILE_BASE}.hpp
-flexheader.commands = @true
-flexheader.variable_out = HEADERS
-flexheader.name = Flex Headers ${QMAKE_FILE_IN}
-flexheader.CONFIG += target_predeps no_link
-
-QMAKE_EXTRA_COMPILERS += flexheader
-
-bisonsource.input = BISONSOURCES
-bisonsource.output = ${QMAKE_FILE_BASE}.cpp
-bisonsource.commands = bison -d --defines=${QMAKE_FILE_BASE}.hpp -o ${QMAKE_FILE_BASE}.cpp ${QMAKE_FILE_IN}
-bisonsource.variable_out = SOURCES
-bisonsource.name = Bison Sources ${QMAKE_FILE_IN}
-bisonsource.CONFIG += target_predeps
-
-QMAKE_EXTRA_COMPILERS += bisonsource
-
-bisonheader.input = BISONSOURCES
-bisonheader.output = ${QMAKE_FILE_BASE}.hpp
-bisonheader.commands = @true
-bisonheader.variable_out = HEADERS
-bisonheader.name = Bison Headers ${QMAKE_FILE_IN}
-bisonheader.CONFIG += target_predeps no_link
-
-QMAKE_EXTRA_COMPILERS += bisonheader
-
-RESOURCES += \
-    ET.qrc
+    $$EQUIVALENCESOURCES \
+    rulecompiler.py
+
+rulebundle.input = EQUIVALENCESOURCES
+rulebundle.output = rulebundle.cpp
+rulebundle.commands = python3 $$PWD/rulecompiler.py ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+rulebundle.depends = $$PWD/rulecompiler.py
+rulebundle.variable_out = SOURCES
+rulebundle.name = Rule Bundle ${QMAKE_FILE_IN}
+rulebundle.CONFIG += target_predeps
+
+QMAKE_EXTRA_COMPILERS += rulebundle
@@ -0,0 +1,101 @@
+#include "arena.hpp"
+
+#include <new>
+
+#define BLOCK_SIZE (64 * 1024)
+
+/* Precedes every allocation, owner is null for heap memory */
+union AllocationHeader
+{
+	Arena *owner;
+	std::max_align_t alignment;
+};
+
+static thread_local Arena *currentArena = nullptr;
+
+QAtomicInt Arena::heapCount(0);
+QAtomicInt Arena::arenaCount(0);
+QAtomicInt Arena::blockCount(0);
+
+Arena::Arena() : cursor(nullptr), limit(nullptr)
+{
+}
+
+Arena::~Arena()
+{
+	for (char *block : blocks)
+		::operator delete(block);
+}
+
+void *Arena::bump(size_t size)
+{
+	const size_t alignment = alignof(std::max_align_t);
+	size = (size + alignment - 1) & ~(alignment - 1);
+
+	if (cursor == nullptr || size_t(limit - cursor) < size) {
+		size_t blockSize = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+
+		cursor = static_cast<char *>(::operator new(blockSize));
+		limit = cursor + blockSize;
+		blocks.append(cursor);
+		blockCount.fetchAndAddRelaxed(1);
+	}
+
+	void *memory = cursor;
+	cursor += size;
+	return memory;
+}
+
+void *Arena::allocate(size_t size)
+{
+	AllocationHeader *header;
+
+	if (currentArena) {
+		header = static_cast<AllocationHeader *>(
+		    currentArena->bump(sizeof(AllocationHeader) + size));
+		arenaCount.fetchAndAddRelaxed(1);
+	} else {
+		header = static_cast<AllocationHeader *>(
+		    ::operator new(sizeof(AllocationHeader) + size));
+		heapCount.fetchAndAddRelaxed(1);
+	}
+
+	header->owner = currentArena;
+	return header + 1;
+}
+
+void Arena::release(void *memory)
+{
+	if (memory == nullptr)
+		return;
+
+	AllocationHeader *header = static_cast<AllocationHeader *>(memory) - 1;
+
+	if (header->owner == nullptr)
+		::operator delete(header);
+}
+
+int Arena::heapAllocations()
+{
+	return heapCount.load();
+}
+
+int Arena::arenaAllocations()
+{
+	return arenaCount.load();
+}
+
+int Arena::blockAllocations()
+{
+	return blockCount.load();
+}
+
+ArenaScope::ArenaScope(Arena *arena) : previous(currentArena)
+{
+	currentArena = arena;
+}
+
+ArenaScope::~ArenaScope()
+{
+	currentArena = previous;
+}
@@ -0,0 +1,53 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <QAtomicInt>
+#include <QVector>
+#include <cstddef>
+
+/* Bump allocator freed in bulk. Classes opt in by forwarding their operator
+ * new and delete to allocate and release; objects created while an
+ * ArenaScope is active on the thread are then placed in its arena and
+ * deleting them runs the destructor but gives no memory back. Everything
+ * allocated in an arena must be dead before the arena is destroyed */
+class Arena
+{
+	QVector<char *> blocks;
+	char *cursor;
+	char *limit;
+
+	static QAtomicInt heapCount;
+	static QAtomicInt arenaCount;
+	static QAtomicInt blockCount;
+
+	void *bump(size_t size);
+
+  public:
+	Arena();
+	~Arena();
+
+	/* Takes memory from the arena of the innermost scope on this thread,
+	 * or from the heap when there is none */
+	static void *allocate(size_t size);
+
+	/* Frees heap memory, arena memory is left to its arena */
+	static void release(void *memory);
+
+	/* Allocations made through allocate since start up, and how many
+	 * blocks the arenas took from the heap to serve theirs */
+	static int heapAllocations();
+	static int arenaAllocations();
+	static int blockAllocations();
+};
+
+/* Makes an arena current on this thread for the lifetime of the scope */
+class ArenaScope
+{
+	Arena *previous;
+
+  public:
+	explicit ArenaScope(Arena *arena);
+	~ArenaScope();
+};
+
+#endif // ARENA_HPP
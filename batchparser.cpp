@@ -0,0 +1,178 @@
+#include "batchparser.hpp"
+#include "AST.hpp"
+#include "arena.hpp"
+#include "formulaparser.hpp"
+
+#include <QThreadPool>
+#include <cstring>
+
+using AST::LogicStatement;
+
+/* Large enough that a worker spends its time parsing rather than taking
+ * chunks, small enough that a few million lines keep every thread busy */
+#define CHUNK_BYTES (256 * 1024)
+
+BatchParser::BatchParser()
+{
+}
+
+BatchParser::~BatchParser()
+{
+	clear();
+}
+
+void BatchParser::clear()
+{
+	/* Destructors free what the nodes keep on the heap, the arenas then
+	 * give back the nodes themselves */
+	for (LogicStatement *statement : statements)
+		delete statement;
+
+	qDeleteAll(arenas);
+	arenas.clear();
+	statements.clear();
+	empty.clear();
+	errors.clear();
+}
+
+bool BatchParser::parse(QFile *file)
+{
+	qint64 size = file->size();
+
+	if (size == 0) {
+		clear();
+		return true;
+	}
+
+	uchar *mapping = file->map(0, size);
+
+	if (mapping != nullptr) {
+		parse(reinterpret_cast<const char *>(mapping), size);
+		file->unmap(mapping);
+		return true;
+	}
+
+	/* Pipes and the like cannot be mapped */
+	QByteArray contents = file->readAll();
+
+	if (contents.isEmpty() && file->error() != QFileDevice::NoError)
+		return false;
+
+	parse(contents.constData(), contents.size());
+	return true;
+}
+
+void BatchParser::parse(const char *text, qint64 size)
+{
+	clear();
+
+	Batch batch;
+	const char *end = text + size;
+
+	/* Chunks end at a line break, so no line is split */
+	for (const char *begin = text; begin < end;) {
+		const char *limit =
+		    end - begin > CHUNK_BYTES ? begin + CHUNK_BYTES : end;
+		const char *newline = static_cast<const char *>(
+		    memchr(limit, '\n', size_t(end - limit)));
+		const char *chunkEnd = limit == end || newline == nullptr
+		                           ? end
+		                           : newline + 1;
+
+		Chunk *chunk = new Chunk;
+		chunk->begin = begin;
+		chunk->end = chunkEnd;
+		chunk->arena = new Arena;
+		batch.chunks.append(chunk);
+		arenas.append(chunk->arena);
+		begin = chunkEnd;
+	}
+
+	batch.nextChunk.store(0);
+
+	int threads = QThreadPool::globalInstance()->maxThreadCount();
+	batch.run(qMin(threads, batch.chunks.size()) - 1);
+
+	for (Chunk *chunk : batch.chunks) {
+		int firstLine = statements.size();
+
+		for (Failure failure : chunk->failures) {
+			failure.line += firstLine;
+			errors.append(failure);
+		}
+
+		statements += chunk->statements;
+		empty += chunk->empty;
+		delete chunk;
+	}
+}
+
+void BatchParser::Batch::work()
+{
+	parseChunks(this);
+}
+
+void BatchParser::parseChunks(Batch *batch)
+{
+	for (;;) {
+		int chunk = batch->nextChunk.fetchAndAddRelaxed(1);
+
+		if (chunk >= batch->chunks.size())
+			return;
+
+		parseChunk(batch->chunks.at(chunk));
+	}
+}
+
+void BatchParser::parseChunk(Chunk *chunk)
+{
+	ArenaScope scope(chunk->arena);
+	FormulaParser parser;
+
+	for (const char *line = chunk->begin; line < chunk->end;) {
+		const char *newline = static_cast<const char *>(
+		    memchr(line, '\n', size_t(chunk->end - line)));
+		const char *lineEnd = newline ? newline : chunk->end;
+		int length = int(lineEnd - line);
+
+		if (length > 0 && line[length - 1] == '\r')
+			--length;
+
+		if (length == 0) {
+			chunk->statements.append(nullptr);
+			chunk->empty.append(true);
+		} else {
+			LogicStatement *statement = parser.parse(line, length);
+
+			if (statement == nullptr)
+				chunk->failures.append(
+				    Failure{chunk->statements.size() + 1,
+				            parser.errorMessage(), parser.errorPosition()});
+
+			chunk->statements.append(statement);
+			chunk->empty.append(false);
+		}
+
+		line = lineEnd + 1;
+	}
+}
+
+int BatchParser::lineCount() const
+{
+	return statements.size();
+}
+
+LogicStatement *BatchParser::statement(int line) const
+{
+	return statements.at(line);
+}
+
+bool BatchParser::isEmpty(int line) const
+{
+	return empty.at(line);
+}
+
+const QVector<BatchParser::Failure> &BatchParser::failures() const
+{
+	return errors;
+}
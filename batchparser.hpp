@@ -0,0 +1,90 @@
+#ifndef BATCHPARSER_HPP
+#define BATCHPARSER_HPP
+
+#include <QAtomicInt>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "paralleljob.hpp"
+
+namespace AST
+{
+class LogicStatement;
+}
+
+class Arena;
+
+/* Parses a UTF-8 text of formulas, one per line. The text is split into
+ * chunks of whole lines that are parsed concurrently on the global thread
+ * pool, each chunk into an arena of its own, and the results are put back
+ * in line order. The ASTs belong to the parser and live as long as it does,
+ * clone one to keep it longer */
+class BatchParser
+{
+  public:
+	struct Failure
+	{
+		/* Counted from 1 */
+		int line;
+		QString message;
+		/* Offset in the line in bytes */
+		int position;
+	};
+
+  private:
+	struct Chunk
+	{
+		const char *begin;
+		const char *end;
+		Arena *arena;
+		/* One entry per line, as for the whole batch */
+		QVector<AST::LogicStatement *> statements;
+		QVector<bool> empty;
+		/* Line numbers counted from the start of the chunk */
+		QVector<Failure> failures;
+	};
+
+	/* Shared state of one concurrent parse */
+	struct Batch : ParallelJob
+	{
+		QVector<Chunk *> chunks;
+		QAtomicInt nextChunk;
+
+		void work();
+	};
+
+	QVector<Arena *> arenas;
+	QVector<AST::LogicStatement *> statements;
+	QVector<bool> empty;
+	QVector<Failure> errors;
+
+	static void parseChunk(Chunk *chunk);
+	static void parseChunks(Batch *batch);
+
+  public:
+	BatchParser();
+	~BatchParser();
+
+	/* Parses the lines of an open file, mapping it into memory when it can
+	 * be. Returns false when the file cannot be read */
+	bool parse(QFile *file);
+
+	/* Parses the lines of text, which is only read during the call */
+	void parse(const char *text, qint64 size);
+
+	/* Drops the results of the last parse */
+	void clear();
+
+	int lineCount() const;
+
+	/* AST of a line counted from 0, nullptr when the line is empty or
+	 * failed to parse */
+	AST::LogicStatement *statement(int line) const;
+
+	bool isEmpty(int line) const;
+
+	/* Lines that failed to parse, in line order */
+	const QVector<Failure> &failures() const;
+};
+
+#endif // BATCHPARSER_HPP
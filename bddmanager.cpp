@@ -0,0 +1,347 @@
+#include "bddmanager.hpp"
+#include "statementwalker.hpp"
+
+#include <QMutexLocker>
+#include <QSet>
+
+using namespace AST;
+
+#define DEFAULT_NODE_LIMIT (1 << 20)
+#define COMPUTED_TABLE_LIMIT (1 << 18)
+#define TERMINAL_VARIABLE (0x7FFFFFFF)
+#define FREE_NODE (-1)
+
+static inline quint32 nodeOf(BddEdge edge)
+{
+	return edge >> 1;
+}
+
+static inline bool isComplemented(BddEdge edge)
+{
+	return edge & 1;
+}
+
+static inline BddEdge complement(BddEdge edge)
+{
+	return edge ^ 1;
+}
+
+BddManager::BddManager(int nodeLimit)
+    : nextVariable(0), nodeLimit(nodeLimit), overflow(false)
+{
+	/* Node 0 is the terminal, its regular edge is TRUE */
+	nodes.append(Node{TERMINAL_VARIABLE, TRUE_EDGE, TRUE_EDGE, 1});
+}
+
+BddManager *BddManager::globalManager()
+{
+	static BddManager manager(DEFAULT_NODE_LIMIT);
+	return &manager;
+}
+
+int BddManager::liveNodeCount()
+{
+	return nodes.size() - freeNodes.size();
+}
+
+int BddManager::nodeCount()
+{
+	QMutexLocker locker(&mutex);
+	return liveNodeCount();
+}
+
+int BddManager::topVariable(BddEdge edge)
+{
+	return nodes.at(nodeOf(edge)).variable;
+}
+
+BddEdge BddManager::cofactor(BddEdge edge, int variable, bool positive)
+{
+	const Node &node = nodes.at(nodeOf(edge));
+
+	if (node.variable != variable)
+		return edge;
+
+	BddEdge child = positive ? node.high : node.low;
+	return isComplemented(edge) ? complement(child) : child;
+}
+
+BddEdge BddManager::makeNode(int variable, BddEdge low, BddEdge high)
+{
+	if (low == high)
+		return low;
+
+	/* Canonical form keeps the high edge regular */
+	if (isComplemented(high))
+		return complement(makeNode(variable, complement(low), complement(high)));
+
+	BddTriple key{variable, low, high};
+	QHash<BddTriple, quint32>::const_iterator found = uniqueTable.find(key);
+
+	if (found != uniqueTable.end())
+		return found.value() << 1;
+
+	if (liveNodeCount() >= nodeLimit) {
+		overflow = true;
+		return TRUE_EDGE;
+	}
+
+	quint32 index;
+	Node node{variable, low, high, 0};
+
+	if (!freeNodes.isEmpty()) {
+		index = freeNodes.takeLast();
+		nodes[index] = node;
+	} else {
+		index = nodes.size();
+		nodes.append(node);
+	}
+
+	uniqueTable.insert(key, index);
+	return index << 1;
+}
+
+BddEdge BddManager::ite(BddEdge f, BddEdge g, BddEdge h)
+{
+	if (overflow)
+		return TRUE_EDGE;
+
+	/* Terminal cases */
+	if (f == TRUE_EDGE)
+		return g;
+	if (f == FALSE_EDGE)
+		return h;
+
+	/* Replace operands equal to the condition by constants */
+	if (g == f)
+		g = TRUE_EDGE;
+	else if (g == complement(f))
+		g = FALSE_EDGE;
+	if (h == f)
+		h = FALSE_EDGE;
+	else if (h == complement(f))
+		h = TRUE_EDGE;
+
+	if (g == h)
+		return g;
+	if (g == TRUE_EDGE && h == FALSE_EDGE)
+		return f;
+	if (g == FALSE_EDGE && h == TRUE_EDGE)
+		return complement(f);
+
+	/* Standard triples: regular condition and regular then-branch */
+	if (isComplemented(f)) {
+		f = complement(f);
+		BddEdge swap = g;
+		g = h;
+		h = swap;
+	}
+
+	bool complementResult = isComplemented(g);
+	if (complementResult) {
+		g = complement(g);
+		h = complement(h);
+	}
+
+	BddTriple key{int(f), g, h};
+	QHash<BddTriple, BddEdge>::const_iterator cached = computedTable.find(key);
+
+	if (cached != computedTable.end())
+		return complementResult ? complement(cached.value()) : cached.value();
+
+	int variable = qMin(topVariable(f), qMin(topVariable(g), topVariable(h)));
+
+	BddEdge high =
+	    ite(cofactor(f, variable, true), cofactor(g, variable, true),
+	        cofactor(h, variable, true));
+	BddEdge low =
+	    ite(cofactor(f, variable, false), cofactor(g, variable, false),
+	        cofactor(h, variable, false));
+	BddEdge result = makeNode(variable, low, high);
+
+	if (overflow)
+		return TRUE_EDGE;
+
+	if (computedTable.size() >= COMPUTED_TABLE_LIMIT)
+		computedTable.clear();
+
+	computedTable.insert(key, result);
+	return complementResult ? complement(result) : result;
+}
+
+BddEdge BddManager::build(LogicStatement *statement)
+{
+	/* Edges built for children whose parent is not built yet */
+	QVector<BddEdge> pending;
+
+	StatementWalker::walk(statement, [this, &pending](LogicStatement *node,
+	                                                  int stage) {
+		if (node->getChild(stage) != nullptr)
+			return StatementWalker::CONTINUE;
+
+		int first = pending.size() - stage;
+		BddEdge left = stage > 0 ? pending.at(first) : TRUE_EDGE;
+		BddEdge right = stage > 1 ? pending.at(first + 1) : TRUE_EDGE;
+		BddEdge edge;
+
+		switch (node->getSymbol()) {
+		case VARIABLE_SYMBOL: {
+			quint32 id = static_cast<Variable *>(node)->getId();
+
+			/* Variables are ordered by first appearance */
+			if (!variableOrder.contains(id))
+				variableOrder.insert(id, nextVariable++);
+
+			edge = makeNode(variableOrder.value(id), FALSE_EDGE, TRUE_EDGE);
+			break;
+		}
+		case TRUTH_SYMBOL:
+			edge = TRUE_EDGE;
+			break;
+		case FALSITY_SYMBOL:
+			edge = FALSE_EDGE;
+			break;
+		case NOT_SYMBOL:
+			edge = complement(left);
+			break;
+		case AND_SYMBOL:
+			edge = ite(left, right, FALSE_EDGE);
+			break;
+		case OR_SYMBOL:
+			edge = ite(left, TRUE_EDGE, right);
+			break;
+		case IMPLIES_SYMBOL:
+			edge = ite(left, right, TRUE_EDGE);
+			break;
+		default:
+			edge = ite(left, right, complement(right));
+			break;
+		}
+
+		pending.resize(first);
+		pending.append(edge);
+
+		/* The diagram is thrown away on overflow, no use finishing it */
+		return overflow ? StatementWalker::STOP : StatementWalker::CONTINUE;
+	});
+
+	return pending.last();
+}
+
+bool BddManager::convert(LogicStatement *statement, BddEdge *edge)
+{
+	/* Only referenced edges survive, so collection happens between
+	 * conversions and never while one is half built */
+	if (liveNodeCount() > nodeLimit / 2)
+		sweep();
+
+	overflow = false;
+	*edge = build(statement);
+
+	if (overflow) {
+		overflow = false;
+		sweep();
+		return false;
+	}
+
+	return true;
+}
+
+bool BddManager::fromStatement(LogicStatement *statement, BddEdge *edge)
+{
+	QMutexLocker locker(&mutex);
+	return convert(statement, edge);
+}
+
+bool BddManager::isEquivalent(LogicStatement *start, LogicStatement *end,
+                              bool *equivalent)
+{
+	QMutexLocker locker(&mutex);
+	BddEdge startEdge;
+	BddEdge endEdge;
+
+	if (!convert(start, &startEdge))
+		return false;
+
+	/* Referenced under the same lock, no other conversion can sweep the
+	 * start diagram before the end one is built */
+	++nodes[nodeOf(startEdge)].references;
+	bool built = convert(end, &endEdge);
+	--nodes[nodeOf(startEdge)].references;
+
+	if (built)
+		*equivalent = startEdge == endEdge;
+
+	return built;
+}
+
+void BddManager::reference(BddEdge edge)
+{
+	QMutexLocker locker(&mutex);
+	++nodes[nodeOf(edge)].references;
+}
+
+void BddManager::dereference(BddEdge edge)
+{
+	QMutexLocker locker(&mutex);
+	--nodes[nodeOf(edge)].references;
+}
+
+void BddManager::mark(quint32 node, QVector<bool> &reachable)
+{
+	if (reachable.at(node))
+		return;
+
+	reachable[node] = true;
+	mark(nodeOf(nodes.at(node).low), reachable);
+	mark(nodeOf(nodes.at(node).high), reachable);
+}
+
+void BddManager::collectGarbage()
+{
+	QMutexLocker locker(&mutex);
+	sweep();
+}
+
+void BddManager::sweep()
+{
+	QVector<bool> reachable(nodes.size(), false);
+
+	for (int index = 0; index < nodes.size(); ++index)
+		if (nodes.at(index).variable != FREE_NODE &&
+		    nodes.at(index).references > 0)
+			mark(index, reachable);
+
+	for (int index = 1; index < nodes.size(); ++index) {
+		Node &node = nodes[index];
+
+		if (reachable.at(index) || node.variable == FREE_NODE)
+			continue;
+
+		uniqueTable.remove(BddTriple{node.variable, node.low, node.high});
+		node.variable = FREE_NODE;
+		freeNodes.append(index);
+	}
+
+	/* Survivors keep their positions, variables they do not test give up
+	 * theirs and the order starts afresh once nothing survives */
+	QSet<int> tested;
+
+	for (int index = 1; index < nodes.size(); ++index)
+		if (nodes.at(index).variable != FREE_NODE)
+			tested.insert(nodes.at(index).variable);
+
+	for (QHash<quint32, int>::iterator it = variableOrder.begin();
+	     it != variableOrder.end();) {
+		if (tested.contains(it.value()))
+			++it;
+		else
+			it = variableOrder.erase(it);
+	}
+
+	if (variableOrder.isEmpty())
+		nextVariable = 0;
+
+	/* Cached results may point at freed nodes */
+	computedTable.clear();
+}
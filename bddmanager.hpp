@@ -0,0 +1,98 @@
+#ifndef BDDMANAGER_HPP
+#define BDDMANAGER_HPP
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "AST.hpp"
+
+/* An edge is the index of a node shifted left by one, with the lowest bit
+ * set when the edge complements the function of the node */
+typedef quint32 BddEdge;
+
+struct BddTriple
+{
+	int variable;
+	BddEdge low;
+	BddEdge high;
+
+	bool operator==(const BddTriple &other) const
+	{
+		return variable == other.variable && low == other.low &&
+		       high == other.high;
+	}
+};
+
+inline uint qHash(const BddTriple &key, uint seed = 0)
+{
+	return (uint(key.variable) * 0x9E3779B1u) ^ (key.low * 0x85EBCA77u) ^
+	       (key.high * 0xC2B2AE3Du) ^ seed;
+}
+
+/* Reduced ordered binary decision diagrams with complement edges. Every
+ * propositional formula maps onto a canonical edge, so two formulas are
+ * equivalent iff their edges are equal. Nodes are shared through a unique
+ * table, ITE results are memorised in a computed table and unreferenced
+ * nodes are reclaimed once the node count approaches its limit */
+class BddManager
+{
+	struct Node
+	{
+		/* Position in the variable order, -1 once the node is freed */
+		int variable;
+		BddEdge low;
+		BddEdge high;
+		int references;
+	};
+
+	QVector<Node> nodes;
+	QVector<quint32> freeNodes;
+	QHash<BddTriple, quint32> uniqueTable;
+	QHash<BddTriple, BddEdge> computedTable;
+	QHash<quint32, int> variableOrder;
+	int nextVariable;
+	int nodeLimit;
+	bool overflow;
+	QMutex mutex;
+
+	BddEdge makeNode(int variable, BddEdge low, BddEdge high);
+	BddEdge ite(BddEdge f, BddEdge g, BddEdge h);
+	BddEdge cofactor(BddEdge edge, int variable, bool positive);
+	int topVariable(BddEdge edge);
+	BddEdge build(AST::LogicStatement *statement);
+	bool convert(AST::LogicStatement *statement, BddEdge *edge);
+	void mark(quint32 node, QVector<bool> &reachable);
+	void sweep();
+	int liveNodeCount();
+
+  public:
+	static const BddEdge TRUE_EDGE = 0;
+	static const BddEdge FALSE_EDGE = 1;
+
+	BddManager(int nodeLimit);
+
+	/* Shared manager for the whole application */
+	static BddManager *globalManager();
+
+	/* Converts a propositional statement into its canonical edge, returns
+	 * false when the node limit is reached before the diagram is complete.
+	 * The edge can be swept by the next conversion unless referenced */
+	bool fromStatement(AST::LogicStatement *statement, BddEdge *edge);
+
+	/* Sets equivalent and returns true unless the node limit is hit */
+	bool isEquivalent(AST::LogicStatement *start, AST::LogicStatement *end,
+	                  bool *equivalent);
+
+	/* Keeps an edge alive across garbage collections */
+	void reference(BddEdge edge);
+	void dereference(BddEdge edge);
+
+	/* Frees every node unreachable from a referenced edge, forgets the
+	 * variables none of the survivors test and drops the computed table */
+	void collectGarbage();
+
+	int nodeCount();
+};
+
+#endif // BDDMANAGER_HPP
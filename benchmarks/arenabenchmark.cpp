@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+#include "AST.hpp"
+#include "arena.hpp"
+#include "equivalenceutility.hpp"
+#include "formulaparser.hpp"
+#include "ruleengine.hpp"
+
+#define INPUT_COUNT 2000
+#define MAX_INPUT_SIZE 8
+#define INPUT_VARIABLE_COUNT 3
+
+using namespace AST;
+
+/* Tries every rule on every input as EquivalenceEngine::match does, inside
+ * an arena per input when scoped. Returns the number of matches */
+static int matchAll(const QVector<LogicStatement *> &inputs,
+                    const QVector<Rule *> &rules, bool scoped)
+{
+	int matches = 0;
+
+	for (LogicStatement *input : inputs) {
+		Arena arena;
+		ArenaScope *scope = scoped ? new ArenaScope(&arena) : nullptr;
+
+		for (Rule *rule : rules) {
+			auto matchingUtility = new EquivalenceUtility();
+
+			if (rule->match(input, matchingUtility))
+				++matches;
+			delete matchingUtility;
+		}
+
+		delete scope;
+	}
+
+	return matches;
+}
+
+/* Heap allocations of rule matching with and without an arena, counted
+ * through Arena and timed */
+void arenaBenchmark()
+{
+	RuleEngine *engine = new RuleEngine;
+	QVector<LogicSet *> *ruleSets = engine->parseRuleXml();
+	QVector<Rule *> rules;
+
+	for (LogicSet *ruleSet : *ruleSets)
+		for (Rule *rule : *ruleSet->getSet())
+			rules.append(rule);
+
+	Benchmark input;
+	FormulaParser parser;
+	QVector<LogicStatement *> inputs;
+
+	for (int i = 0; i < INPUT_COUNT; ++i)
+		inputs.append(parser.parse(input.formula(input.next(MAX_INPUT_SIZE),
+		                                         INPUT_VARIABLE_COUNT)));
+
+	for (bool scoped : {false, true}) {
+		QString measurement =
+		    QString(scoped ? "arena per input, %1" : "heap, %1");
+		int heap = Arena::heapAllocations();
+		int arena = Arena::arenaAllocations();
+		int blocks = Arena::blockAllocations();
+		QElapsedTimer timer;
+
+		timer.start();
+		int matches = matchAll(inputs, rules, scoped);
+		double seconds = Benchmark::seconds(timer);
+
+		Benchmark::report("arena", measurement.arg("matches"),
+		                  double(matches) / INPUT_COUNT, "/input");
+		Benchmark::report("arena", measurement.arg("heap allocations"),
+		                  double(Arena::heapAllocations() - heap) /
+		                      INPUT_COUNT,
+		                  "/input");
+		Benchmark::report("arena", measurement.arg("arena allocations"),
+		                  double(Arena::arenaAllocations() - arena) /
+		                      INPUT_COUNT,
+		                  "/input");
+		Benchmark::report("arena", measurement.arg("arena blocks"),
+		                  double(Arena::blockAllocations() - blocks) /
+		                      INPUT_COUNT,
+		                  "/input");
+		Benchmark::report("arena", measurement.arg("time"),
+		                  seconds * 1e6 / INPUT_COUNT, "us/input");
+	}
+
+	qDeleteAll(inputs);
+	for (LogicSet *ruleSet : *ruleSets) {
+		ruleSet->deepDeleteContent();
+		delete ruleSet;
+	}
+	delete engine;
+}
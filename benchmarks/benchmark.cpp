@@ -0,0 +1,47 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+
+Benchmark::Benchmark(quint64 seed) : state(seed)
+{
+}
+
+int Benchmark::next(int bound)
+{
+	/* xorshift64*, as the simulation in BitSlicedEvaluator */
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+
+	return int(((state * 0x2545F4914F6CDD1DULL) >> 33) % quint64(bound));
+}
+
+QString Benchmark::formula(int size, int variables)
+{
+	static const char *const CONNECTIVES[] = {"∧", "∨", "→", "↔"};
+
+	if (size == 0) {
+		QString variable = QString("p%1").arg(next(variables));
+		return next(4) == 0 ? QString("¬") + variable : variable;
+	}
+
+	int left = next(size);
+	QString leftFormula = formula(left, variables);
+	QString connective = QString::fromUtf8(CONNECTIVES[next(4)]);
+	QString rightFormula = formula(size - 1 - left, variables);
+
+	return QString("(%1 %2 %3)").arg(leftFormula, connective, rightFormula);
+}
+
+void Benchmark::report(const char *benchmark, const QString &measurement,
+                       double value, const char *unit)
+{
+	printf("%-12s %-36s %14.2f %s\n", benchmark,
+	       measurement.toUtf8().constData(), value, unit);
+	fflush(stdout);
+}
+
+double Benchmark::seconds(const QElapsedTimer &timer)
+{
+	return timer.nsecsElapsed() / 1e9;
+}
@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <QElapsedTimer>
+#include <QString>
+
+/* Inputs and output shared by the benchmarks. Inputs are drawn from a
+ * pseudo random sequence with a fixed seed, so two runs measure the same
+ * work */
+class Benchmark
+{
+	quint64 state;
+
+  public:
+	explicit Benchmark(quint64 seed = 1);
+
+	/* Uniform in [0, bound) */
+	int next(int bound);
+
+	/* Fully bracketed propositional formula with size binary connectives
+	 * over the variables p0 to p(variables - 1) */
+	QString formula(int size, int variables);
+
+	/* Writes one line of results, "benchmark  measurement  value unit" */
+	static void report(const char *benchmark, const QString &measurement,
+	                   double value, const char *unit);
+
+	/* Seconds elapsed on a started timer */
+	static double seconds(const QElapsedTimer &timer);
+};
+
+void parserBenchmark();
+void depthBenchmark();
+void ruleBaseBenchmark();
+void bitSlicedBenchmark();
+void arenaBenchmark();
+void visitorBenchmark();
+void flatFormulaBenchmark();
+
+#endif // BENCHMARK_HPP
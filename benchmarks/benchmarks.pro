@@ -0,0 +1,113 @@
+#-------------------------------------------------
+#
+# ET benchmarks, built apart from the application
+#
+#   qmake benchmarks.pro && make && ./benchmarks [name ...]
+#
+#-------------------------------------------------
+
+QT       += core concurrent
+QT       -= gui
+
+TARGET = benchmarks
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ..
+
+# Read by the rule base benchmark, which times reading it against the tables
+# compiled from it
+DEFINES += EQUIVALENCES_XML=\\\"$$PWD/../equivalences.xml\\\"
+
+SOURCES += main.cpp \
+    benchmark.cpp \
+    parserbenchmark.cpp \
+    depthbenchmark.cpp \
+    rulebasebenchmark.cpp \
+    bitslicedbenchmark.cpp \
+    arenabenchmark.cpp \
+    visitorbenchmark.cpp \
+    flatformulabenchmark.cpp \
+    parsercontext.cpp \
+    ../AST.cpp \
+    ../idtable.cpp \
+    ../logicset.cpp \
+    ../equivalenceutility.cpp \
+    ../bitslicedevaluator.cpp \
+    ../satsolver.cpp \
+    ../tseitinencoder.cpp \
+    ../bddmanager.cpp \
+    ../modelchecker.cpp \
+    ../formuladag.cpp \
+    ../arena.cpp \
+    ../symboltable.cpp \
+    ../flatformula.cpp \
+    ../formulapath.cpp \
+    ../formulaparser.cpp \
+    ../batchparser.cpp \
+    ../paralleljob.cpp \
+    ../ruleengine.cpp \
+    ../rulekey.cpp
+
+HEADERS  += benchmark.hpp \
+    parsercontext.hpp
+
+# The bison parser the application used to have, kept as the reference the
+# hand written one is measured against
+FLEXSOURCES = lexer.l
+BISONSOURCES = parser.y
+
+EQUIVALENCESOURCES = ../equivalences.xml
+
+OTHER_FILES +=  \
+    $$FLEXSOURCES \
+    $$BISONSOURCES \
+    $$EQUIVALENCESOURCES
+
+flexsource.input = FLEXSOURCES
+flexsource.output = ${QMAKE_FILE_BASE}.cpp
+flexsource.commands = flex --header-file=${QMAKE_FILE_BASE}.hpp -o ${QMAKE_FILE_BASE}.cpp ${QMAKE_FILE_IN}
+flexsource.variable_out = SOURCES
+flexsource.name = Flex Sources ${QMAKE_FILE_IN}
+flexsource.CONFIG += target_predeps
+
+QMAKE_EXTRA_COMPILERS += flexsource
+
+flexheader.input = FLEXSOURCES
+flexheader.output = ${QMAKE_FILE_BASE}.hpp
+flexheader.commands = @true
+flexheader.variable_out = HEADERS
+flexheader.name = Flex Headers ${QMAKE_FILE_IN}
+flexheader.CONFIG += target_predeps no_link
+
+QMAKE_EXTRA_COMPILERS += flexheader
+
+bisonsource.input = BISONSOURCES
+bisonsource.output = ${QMAKE_FILE_BASE}.cpp
+bisonsource.commands = bison -d --defines=${QMAKE_FILE_BASE}.hpp -o ${QMAKE_FILE_BASE}.cpp ${QMAKE_FILE_IN}
+bisonsource.variable_out = SOURCES
+bisonsource.name = Bison Sources ${QMAKE_FILE_IN}
+bisonsource.CONFIG += target_predeps
+
+QMAKE_EXTRA_COMPILERS += bisonsource
+
+bisonheader.input = BISONSOURCES
+bisonheader.output = ${QMAKE_FILE_BASE}.hpp
+bisonheader.commands = @true
+bisonheader.variable_out = HEADERS
+bisonheader.name = Bison Headers ${QMAKE_FILE_IN}
+bisonheader.CONFIG += target_predeps no_link
+
+QMAKE_EXTRA_COMPILERS += bisonheader
+
+rulebundle.input = EQUIVALENCESOURCES
+rulebundle.output = rulebundle.cpp
+rulebundle.commands = python3 $$PWD/../rulecompiler.py ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+rulebundle.depends = $$PWD/../rulecompiler.py
+rulebundle.variable_out = SOURCES
+rulebundle.name = Rule Bundle ${QMAKE_FILE_IN}
+rulebundle.CONFIG += target_predeps
+
+QMAKE_EXTRA_COMPILERS += rulebundle
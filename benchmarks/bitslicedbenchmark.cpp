@@ -0,0 +1,149 @@
+#include "benchmark.hpp"
+#include "AST.hpp"
+#include "bitslicedevaluator.hpp"
+#include "formulaparser.hpp"
+
+#include <QThread>
+#include <QThreadPool>
+
+#define FORMULA_PAIRS 20
+#define FORMULA_SIZE 40
+#define WIDE_FORMULA_SIZE 100
+
+using namespace AST;
+
+/* The truth table the way isEquivalent used to walk it, one row at a time
+ * through setBooleanValue and evaluate */
+static bool rowByRow(LogicStatement *left, LogicStatement *right,
+                     quint64 *rows)
+{
+	auto variables = new QVector<QVector<Variable *> *>();
+	bool equivalent = true;
+
+	left->collectVariables(variables);
+	right->collectVariables(variables);
+
+	quint64 rowCount = quint64(1) << variables->size();
+
+	for (quint64 row = 0; row < rowCount && equivalent; ++row) {
+		for (int i = 0; i < variables->size(); ++i)
+			for (Variable *variable : *variables->at(i))
+				variable->setBooleanValue((row >> i) & 1);
+
+		equivalent = left->evaluate() == right->evaluate();
+	}
+
+	*rows += rowCount;
+	left->list_destroy(variables);
+	return equivalent;
+}
+
+/* The widest truth tables the evaluator sweeps, the ones split over the pool,
+ * on one thread and up to as many as there are cores */
+static void threads(Benchmark *input, FormulaParser *parser)
+{
+	static const int VARIABLE_COUNTS[] = {20, 24, 28};
+	QThreadPool *pool = QThreadPool::globalInstance();
+	int maxThreads = pool->maxThreadCount();
+
+	for (int variableCount : VARIABLE_COUNTS) {
+		LogicStatement *formula = nullptr;
+
+		/* Until every variable occurs, so the table is as wide as named */
+		do {
+			delete formula;
+			formula = parser->parse(
+			    input->formula(WIDE_FORMULA_SIZE, variableCount));
+		} while (BitSlicedEvaluator(formula, formula).variableCount() <
+		         variableCount);
+
+		LogicStatement *clone = formula->clone();
+		BitSlicedEvaluator evaluator(formula, clone);
+		quint64 rows = quint64(1) << evaluator.variableCount();
+
+		for (int threadCount = 1; threadCount <= QThread::idealThreadCount();
+		     ++threadCount) {
+			QString measurement = QString("%1 variables, %2 threads")
+			                          .arg(evaluator.variableCount())
+			                          .arg(threadCount);
+			QElapsedTimer timer;
+			bool equivalent;
+
+			pool->setMaxThreadCount(threadCount);
+			timer.start();
+			bool decided = evaluator.isEquivalent(&equivalent);
+			double seconds = Benchmark::seconds(timer);
+
+			if (!decided || !equivalent)
+				Benchmark::report("bitsliced", measurement + ", WRONG RESULT",
+				                  0, "");
+			Benchmark::report("bitsliced", measurement, rows / seconds / 1e6,
+			                  "Mrows/s");
+		}
+
+		delete formula;
+		delete clone;
+	}
+
+	pool->setMaxThreadCount(maxThreads);
+}
+
+/* Complete truth tables of a formula against its clone, so every row is
+ * checked, per row against 64 rows to a word, then the widest ones per
+ * number of threads */
+void bitSlicedBenchmark()
+{
+	static const int VARIABLE_COUNTS[] = {8, 12, 16};
+	Benchmark input;
+	FormulaParser parser;
+
+	for (int variableCount : VARIABLE_COUNTS) {
+		QVector<LogicStatement *> formulas;
+		QVector<LogicStatement *> clones;
+
+		for (int i = 0; i < FORMULA_PAIRS; ++i) {
+			formulas.append(
+			    parser.parse(input.formula(FORMULA_SIZE, variableCount)));
+			clones.append(formulas.last()->clone());
+		}
+
+		QElapsedTimer timer;
+		quint64 rowByRowRows = 0;
+		int disagreements = 0;
+
+		timer.start();
+		for (int i = 0; i < FORMULA_PAIRS; ++i)
+			if (!rowByRow(formulas.at(i), clones.at(i), &rowByRowRows))
+				++disagreements;
+		double rowByRowSeconds = Benchmark::seconds(timer);
+
+		quint64 bitSlicedRows = 0;
+
+		timer.start();
+		for (int i = 0; i < FORMULA_PAIRS; ++i) {
+			BitSlicedEvaluator evaluator(formulas.at(i), clones.at(i));
+			bool equivalent;
+
+			bitSlicedRows += quint64(1) << evaluator.variableCount();
+			if (!evaluator.isEquivalent(&equivalent) || !equivalent)
+				++disagreements;
+		}
+		double bitSlicedSeconds = Benchmark::seconds(timer);
+
+		QString measurement = QString("%1 variables, %2").arg(variableCount);
+
+		if (disagreements != 0 || rowByRowRows != bitSlicedRows)
+			Benchmark::report("bitsliced", measurement.arg("WRONG RESULT"),
+			                  disagreements, "pairs");
+
+		Benchmark::report("bitsliced", measurement.arg("row by row"),
+		                  rowByRowRows / rowByRowSeconds / 1e6, "Mrows/s");
+		Benchmark::report("bitsliced", measurement.arg("bit sliced"),
+		                  bitSlicedRows / bitSlicedSeconds / 1e6, "Mrows/s");
+
+		qDeleteAll(formulas);
+		qDeleteAll(clones);
+	}
+
+	threads(&input, &parser);
+}
@@ -0,0 +1,170 @@
+#include "benchmark.hpp"
+#include "AST.hpp"
+#include "formulaparser.hpp"
+#include "statementwalker.hpp"
+#include "symboltable.hpp"
+
+#include <QVector>
+
+#define DEEP_DEPTH 1000000
+#define DEEP_VARIABLE_COUNT 32
+#define SHALLOW_FORMULA_COUNT 100000
+#define MAX_SHALLOW_SIZE 40
+#define SHALLOW_VARIABLE_COUNT 8
+#define SHALLOW_ROUNDS 5
+
+using namespace AST;
+
+static Variable *variable(int index)
+{
+	return new Variable(
+	    SymbolTable::globalTable()->intern(QString("p%1").arg(index)));
+}
+
+/* The walk every operation on a formula used to be */
+static int recursiveNodeCount(LogicStatement *statement)
+{
+	int count = 1;
+
+	for (int i = 0; LogicStatement *child = statement->getChild(i); ++i)
+		count += recursiveNodeCount(child);
+
+	return count;
+}
+
+static int walkedNodeCount(LogicStatement *statement)
+{
+	int count = 0;
+
+	StatementWalker::walk(statement, [&count](LogicStatement *, int stage) {
+		if (stage == 0)
+			++count;
+		return StatementWalker::CONTINUE;
+	});
+
+	return count;
+}
+
+/* Times every operation that walks a formula on one formula too deep for
+ * the native stack */
+static void deep(const char *shape, LogicStatement *formula)
+{
+	QElapsedTimer timer;
+	QString measurement = QString("%1, %2").arg(shape);
+
+	timer.start();
+	QString text = formula->print(true);
+	Benchmark::report("depth", measurement.arg("print"),
+	                  Benchmark::seconds(timer), "s");
+
+	timer.start();
+	LogicStatement *copy = formula->clone();
+	Benchmark::report("depth", measurement.arg("clone"),
+	                  Benchmark::seconds(timer), "s");
+
+	timer.start();
+	bool equal = formula->equals(copy);
+	Benchmark::report("depth", measurement.arg("equals"),
+	                  Benchmark::seconds(timer), "s");
+
+	timer.start();
+	bool equivalent = formula->isEquivalent(copy);
+	Benchmark::report("depth", measurement.arg("isEquivalent"),
+	                  Benchmark::seconds(timer), "s");
+
+	timer.start();
+	int nodes = walkedNodeCount(formula);
+	Benchmark::report("depth", measurement.arg("walk"),
+	                  Benchmark::seconds(timer), "s");
+
+	timer.start();
+	delete copy;
+	Benchmark::report("depth", measurement.arg("delete"),
+	                  Benchmark::seconds(timer), "s");
+
+	if (text.isEmpty() || !equal || !equivalent ||
+	    nodes != formula->nodeCount())
+		Benchmark::report("depth", measurement.arg("WRONG RESULT"), 0, "");
+
+	delete formula;
+}
+
+/* Formulas a million levels deep through every walk, then the walker
+ * against plain recursion on the shallow formulas users actually enter */
+void depthBenchmark()
+{
+	LogicStatement *negations = variable(0);
+
+	for (int i = 0; i < DEEP_DEPTH; ++i)
+		negations = new NotStatement(negations);
+
+	deep("negations", negations);
+
+	LogicStatement *conjunction = variable(0);
+
+	/* More variables than the truth table takes, so the diagrams and the
+	 * SAT solver are walked as well */
+	for (int i = 1; i < DEEP_DEPTH; ++i)
+		conjunction =
+		    new AndStatement(conjunction, variable(i % DEEP_VARIABLE_COUNT));
+
+	deep("conjunction", conjunction);
+
+	Benchmark input;
+	FormulaParser parser;
+	QVector<LogicStatement *> formulas;
+	QElapsedTimer timer;
+	long long recursiveNodes = 0;
+	long long walkedNodes = 0;
+
+	for (int i = 0; i < SHALLOW_FORMULA_COUNT; ++i)
+		formulas.append(parser.parse(input.formula(
+		    input.next(MAX_SHALLOW_SIZE) + 1, SHALLOW_VARIABLE_COUNT)));
+
+	double recursiveSeconds = 0;
+	double walkedSeconds = 0;
+
+	/* Alternated and the best round kept, so neither walk pays for bringing
+	 * the formulas into the cache */
+	for (int round = 0; round < SHALLOW_ROUNDS; ++round) {
+		timer.start();
+		for (LogicStatement *formula : formulas)
+			recursiveNodes += recursiveNodeCount(formula);
+		double seconds = Benchmark::seconds(timer);
+		if (round == 0 || seconds < recursiveSeconds)
+			recursiveSeconds = seconds;
+
+		timer.start();
+		for (LogicStatement *formula : formulas)
+			walkedNodes += walkedNodeCount(formula);
+		seconds = Benchmark::seconds(timer);
+		if (round == 0 || seconds < walkedSeconds)
+			walkedSeconds = seconds;
+	}
+
+	if (recursiveNodes != walkedNodes)
+		Benchmark::report("depth", "WRONG RESULT", 0, "");
+
+	Benchmark::report("depth", "shallow, recursive node count",
+	                  recursiveSeconds * 1e9 / SHALLOW_FORMULA_COUNT,
+	                  "ns/formula");
+	Benchmark::report("depth", "shallow, walked node count",
+	                  walkedSeconds * 1e9 / SHALLOW_FORMULA_COUNT,
+	                  "ns/formula");
+
+	timer.start();
+	for (LogicStatement *formula : formulas)
+		delete formula->clone();
+	Benchmark::report("depth", "shallow, clone and delete",
+	                  Benchmark::seconds(timer) * 1e9 / SHALLOW_FORMULA_COUNT,
+	                  "ns/formula");
+
+	timer.start();
+	for (LogicStatement *formula : formulas)
+		formula->print(true);
+	Benchmark::report("depth", "shallow, print",
+	                  Benchmark::seconds(timer) * 1e9 / SHALLOW_FORMULA_COUNT,
+	                  "ns/formula");
+
+	qDeleteAll(formulas);
+}
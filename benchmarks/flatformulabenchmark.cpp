@@ -0,0 +1,69 @@
+#include "benchmark.hpp"
+#include "AST.hpp"
+#include "flatformula.hpp"
+#include "formulaparser.hpp"
+
+#define MIN_NODES 1000
+#define MAX_NODES 1000000
+#define VARIABLE_COUNT 8
+/* Nodes visited per measurement, whatever the size of the formula */
+#define NODES_PER_MEASUREMENT 4000000
+
+using namespace AST;
+
+/* FlatFormula against the pointer tree it is built from, for formulas of
+ * 10^3 to 10^6 nodes: building a copy, and comparing two equal copies
+ * node by node */
+void flatFormulaBenchmark()
+{
+	Benchmark input;
+	FormulaParser parser;
+
+	for (int target = MIN_NODES; target <= MAX_NODES; target *= 10) {
+		/* About two nodes per connective, the variables and the negations
+		 * of some of them */
+		LogicStatement *formula =
+		    parser.parse(input.formula(target / 2, VARIABLE_COUNT));
+		LogicStatement *copy = formula->clone();
+		int nodes = formula->nodeCount();
+		int repeats = qMax(1, NODES_PER_MEASUREMENT / nodes);
+		double perNode = 1e9 / (double(nodes) * repeats);
+		QString measurement = QString("%1 nodes, %2, %3").arg(nodes);
+		QElapsedTimer timer;
+		int checks = 0;
+
+		timer.start();
+		for (int i = 0; i < repeats; ++i)
+			delete formula->clone();
+		Benchmark::report("flat", measurement.arg("tree", "build"),
+		                  Benchmark::seconds(timer) * perNode, "ns/node");
+
+		timer.start();
+		for (int i = 0; i < repeats; ++i)
+			checks += FlatFormula(formula).size() == nodes;
+		Benchmark::report("flat", measurement.arg("flat", "build"),
+		                  Benchmark::seconds(timer) * perNode, "ns/node");
+
+		timer.start();
+		for (int i = 0; i < repeats; ++i)
+			checks += formula->equals(copy);
+		Benchmark::report("flat", measurement.arg("tree", "equals"),
+		                  Benchmark::seconds(timer) * perNode, "ns/node");
+
+		/* Built apart, so the arrays are not shared */
+		FlatFormula flat(formula);
+		FlatFormula flatCopy(copy);
+
+		timer.start();
+		for (int i = 0; i < repeats; ++i)
+			checks += flat == flatCopy;
+		Benchmark::report("flat", measurement.arg("flat", "equals"),
+		                  Benchmark::seconds(timer) * perNode, "ns/node");
+
+		if (checks != 3 * repeats)
+			Benchmark::report("flat", "WRONG RESULT", 0, "");
+
+		delete formula;
+		delete copy;
+	}
+}
@@ -0,0 +1,45 @@
+#include "benchmark.hpp"
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <cstdio>
+
+struct Entry
+{
+	const char *name;
+	void (*run)();
+};
+
+/* Run in this order when none is named on the command line */
+static const Entry BENCHMARKS[] = {
+    {"parser", parserBenchmark},
+    {"depth", depthBenchmark},
+    {"rulebase", ruleBaseBenchmark},
+    {"bitsliced", bitSlicedBenchmark},
+    {"arena", arenaBenchmark},
+    {"visitor", visitorBenchmark},
+    {"flat", flatFormulaBenchmark},
+};
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QStringList names = a.arguments().mid(1);
+	int ran = 0;
+
+	for (const Entry &entry : BENCHMARKS)
+		if (names.isEmpty() || names.contains(entry.name)) {
+			entry.run();
+			++ran;
+		}
+
+	if (ran == 0) {
+		fprintf(stderr, "Usage: benchmarks [name ...], names being");
+		for (const Entry &entry : BENCHMARKS)
+			fprintf(stderr, " %s", entry.name);
+		fprintf(stderr, "\n");
+		return 1;
+	}
+
+	return 0;
+}
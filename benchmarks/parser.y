@@ -1,14 +1,27 @@
-%{
+%code requires {
         #include "AST.hpp"
 
-        AST::LogicStatement *entireStatement; // Top of the LogicStatement
+        class ParserContext;
 
-        extern QString parserErrorMessage;
-        void yyerror(const char *s) {
-            parserErrorMessage = s;
+        /* As declared by the scanner header, which needs YYSTYPE */
+        #ifndef YY_TYPEDEF_YY_SCANNER_T
+        #define YY_TYPEDEF_YY_SCANNER_T
+        typedef void *yyscan_t;
+        #endif
+}
+
+%code {
+        #include "parsercontext.hpp"
+
+        void yyerror(yyscan_t, ParserContext *context, const char *s) {
+            context->parserError(s);
         }
-        extern int yylex(void);
-%}
+        extern int yylex(YYSTYPE *yylval, yyscan_t scanner);
+}
+
+%define api.pure full
+%lex-param {yyscan_t scanner}
+%parse-param {yyscan_t scanner} {ParserContext *context}
 
 %error-verbose
 
@@ -30,7 +43,7 @@
         AST::Parameters* parameters;
         AST::PredicateSymbolStatement* predicateSymbolStatement;
         AST::EqualityStatement* equalityStatement;
-        QString* qString;
+        quint32 symbolId;
         int token;
 }
 
@@ -46,10 +59,10 @@
 %token <token> IFF
 %token <token> TRUTH
 %token <token> FALSITY
-%token <qString> IDENTIFIER
+%token <symbolId> IDENTIFIER
 %token <token> COMMA
 
-%type <logicStatement> MainStatement LogicStatement
+%type <logicStatement> LogicStatement
 %type <variable> Variable
 //%type <truth> Truth
 //%type <falsity> Falsity
@@ -67,6 +80,14 @@
 %type <impliesStatement> ImpliesStatement;
 %type <iffStatement> IffStatement;
 
+/* Statements built before an error are not part of any result */
+%destructor { delete $$; } <logicStatement> <variable> <unaryOpStatement>
+%destructor { delete $$; } <notStatement> <binaryOpStatement> <andStatement>
+%destructor { delete $$; } <orStatement> <iffStatement> <impliesStatement>
+%destructor { delete $$; } <firstOrderStatement> <forAllStatement>
+%destructor { delete $$; } <thereExistsStatement> <parameters>
+%destructor { delete $$; } <predicateSymbolStatement> <equalityStatement>
+
 %left COMMA
 %left IDENTIFIER
 %left FALSITY
@@ -84,9 +105,9 @@
 
 %%
 
-MainStatement : {entireStatement = NULL;}
+MainStatement : {context->accept(NULL);}
               | LogicStatement
-              { entireStatement = $1; }
+              { context->accept($1); }
 
 LogicStatement : LBRACKET LogicStatement RBRACKET
                { $$ = $2; }
@@ -105,9 +126,7 @@ LogicStatement : LBRACKET LogicStatement RBRACKET
                ;
 
 Variable : IDENTIFIER
-         { $$ = new AST::Variable(*$1);
-           delete $1;
-         }
+         { $$ = new AST::Variable($1); }
          ;
 
 FirstOrderStatement : ForAllStatement
@@ -176,6 +195,3 @@ IffStatement : LogicStatement IFF LogicStatement
              { $$ = new AST::IffStatement($1, $3); }
              ;
 %%
-int yywrap(void) {
-    return 1;
-}
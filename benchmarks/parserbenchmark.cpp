@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+#include "parsercontext.hpp"
+#include "AST.hpp"
+#include "batchparser.hpp"
+#include "formulaparser.hpp"
+
+#include <QVector>
+
+#define FORMULA_COUNT 100000
+#define MAX_FORMULA_SIZE 40
+#define VARIABLE_COUNT 8
+
+/* Parse throughput of the hand written parser against the bison one it
+ * replaced, formula by formula and as one file through BatchParser */
+void parserBenchmark()
+{
+	Benchmark input;
+	QVector<QString> formulas;
+	QByteArray file;
+
+	for (int i = 0; i < FORMULA_COUNT; ++i) {
+		formulas.append(input.formula(input.next(MAX_FORMULA_SIZE) + 1,
+		                              VARIABLE_COUNT));
+		file += formulas.last().toUtf8();
+		file += '\n';
+	}
+
+	double megabytes = file.size() / 1e6;
+	FormulaParser parser;
+	ParserContext context;
+	QElapsedTimer timer;
+
+	/* Speed means nothing unless both build the same ASTs */
+	int disagreements = 0;
+
+	for (const QString &formula : formulas) {
+		AST::LogicStatement *handWritten = parser.parse(formula);
+		AST::LogicStatement *bison = context.parse(formula);
+
+		if (handWritten == nullptr || bison == nullptr ||
+		    !handWritten->equals(bison))
+			++disagreements;
+
+		delete handWritten;
+		delete bison;
+	}
+
+	Benchmark::report("parser", "ASTs differing from bison", disagreements,
+	                  "formulas");
+
+	timer.start();
+	for (const QString &formula : formulas)
+		delete context.parse(formula);
+	double bisonSeconds = Benchmark::seconds(timer);
+
+	timer.start();
+	for (const QString &formula : formulas)
+		delete parser.parse(formula);
+	double handWrittenSeconds = Benchmark::seconds(timer);
+
+	timer.start();
+	BatchParser batch;
+	batch.parse(file.constData(), file.size());
+	double batchSeconds = Benchmark::seconds(timer);
+
+	Benchmark::report("parser", "bison", megabytes / bisonSeconds, "MB/s");
+	Benchmark::report("parser", "bison", FORMULA_COUNT / bisonSeconds,
+	                  "formulas/s");
+	Benchmark::report("parser", "hand written",
+	                  megabytes / handWrittenSeconds, "MB/s");
+	Benchmark::report("parser", "hand written",
+	                  FORMULA_COUNT / handWrittenSeconds, "formulas/s");
+	Benchmark::report("parser", "batch of lines", megabytes / batchSeconds,
+	                  "MB/s");
+	Benchmark::report("parser", "batch of lines",
+	                  FORMULA_COUNT / batchSeconds, "formulas/s");
+}
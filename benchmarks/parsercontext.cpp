@@ -0,0 +1,92 @@
+#include "parsercontext.hpp"
+#include "AST.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+
+ParserContext::ParserContext()
+    : scanner(nullptr), result(nullptr), position(-1), tokenStart(0),
+      tokenEnd(0), scannerFailed(false)
+{
+	yylex_init_extra(this, &scanner);
+}
+
+ParserContext::~ParserContext()
+{
+	yylex_destroy(scanner);
+}
+
+AST::LogicStatement *ParserContext::parse(const QString &expression)
+{
+	result = nullptr;
+	message.clear();
+	position = -1;
+	tokenStart = 0;
+	tokenEnd = 0;
+	scannerFailed = false;
+
+	QByteArray text = expression.toUtf8();
+	YY_BUFFER_STATE buffer = yy_scan_bytes(text.constData(), text.size(),
+	                                       scanner);
+	int failed = yyparse(scanner, this);
+	yy_delete_buffer(buffer, scanner);
+
+	/* The scanner ends the input at an unknown token, which the parser may
+	 * well accept */
+	if (failed || scannerFailed) {
+		delete result;
+		return nullptr;
+	}
+
+	if (result == nullptr) {
+		message = QString("Empty formula");
+		position = 0;
+		return nullptr;
+	}
+
+	if (result->isFirstOrderLogic() && !result->validFirstOrderStatement()) {
+		message = QString("Invalid first order statement");
+		position = 0;
+		delete result;
+		return nullptr;
+	}
+
+	return result;
+}
+
+const QString &ParserContext::errorMessage() const
+{
+	return message;
+}
+
+int ParserContext::errorPosition() const
+{
+	return position;
+}
+
+void ParserContext::advance(int length)
+{
+	tokenStart = tokenEnd;
+	tokenEnd += length;
+}
+
+void ParserContext::scannerError(const QString &message)
+{
+	scannerFailed = true;
+	this->message = message;
+	position = tokenStart;
+}
+
+void ParserContext::parserError(const QString &message)
+{
+	/* The parser gives up at the end of input the scanner made */
+	if (scannerFailed)
+		return;
+
+	this->message = message;
+	position = tokenStart;
+}
+
+void ParserContext::accept(AST::LogicStatement *statement)
+{
+	result = statement;
+}
@@ -0,0 +1,47 @@
+#ifndef PARSERCONTEXT_HPP
+#define PARSERCONTEXT_HPP
+
+#include <QString>
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* State of one parse, shared by the reentrant scanner and parser. A context
+ * parses on the thread using it, any number of contexts may parse at once */
+class ParserContext
+{
+	void *scanner;
+	AST::LogicStatement *result;
+	QString message;
+	int position;
+	/* Character offsets in the input of the current token and of the
+	 * character after it */
+	int tokenStart;
+	int tokenEnd;
+	bool scannerFailed;
+
+  public:
+	ParserContext();
+	~ParserContext();
+
+	/* Returns a newly allocated AST for expression, or nullptr when it is
+	 * not well formed, errorMessage and errorPosition then telling why */
+	AST::LogicStatement *parse(const QString &expression);
+
+	const QString &errorMessage() const;
+
+	/* Offset in the expression of the character the error was found at */
+	int errorPosition() const;
+
+	/* Called by the scanner on every token, length in characters */
+	void advance(int length);
+
+	/* Called by the scanner and by the parser */
+	void scannerError(const QString &message);
+	void parserError(const QString &message);
+	void accept(AST::LogicStatement *statement);
+};
+
+#endif // PARSERCONTEXT_HPP
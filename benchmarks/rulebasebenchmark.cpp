@@ -0,0 +1,60 @@
+#include "benchmark.hpp"
+#include "ruleengine.hpp"
+
+#include <QFile>
+#include <QXmlStreamReader>
+
+#define RULE_BASE_LOADS 100
+
+/* Loading the rule base as start up does, from the tables compiled out of
+ * equivalences.xml, against merely reading the XML the way start up used to.
+ * Reading builds no rules, so it is a lower bound of the old load. Run from
+ * a directory without userDefinedRules.xml to time a first launch */
+void ruleBaseBenchmark()
+{
+	QFile file(EQUIVALENCES_XML);
+
+	if (!file.open(QIODevice::ReadOnly)) {
+		Benchmark::report("rulebase", "equivalences.xml missing", 0, "");
+		return;
+	}
+
+	QByteArray xml = file.readAll();
+	QElapsedTimer timer;
+	int elements = 0;
+
+	timer.start();
+	for (int i = 0; i < RULE_BASE_LOADS; ++i) {
+		QXmlStreamReader reader(xml);
+
+		while (!reader.atEnd())
+			if (reader.readNext() == QXmlStreamReader::StartElement)
+				++elements;
+	}
+	double readSeconds = Benchmark::seconds(timer);
+
+	int ruleSets = 0;
+
+	timer.start();
+	for (int i = 0; i < RULE_BASE_LOADS; ++i) {
+		RuleEngine *engine = new RuleEngine;
+		QVector<LogicSet *> *rules = engine->parseRuleXml();
+
+		ruleSets += rules->size();
+		for (LogicSet *ruleSet : *rules) {
+			ruleSet->deepDeleteContent();
+			delete ruleSet;
+		}
+		delete engine;
+	}
+	double loadSeconds = Benchmark::seconds(timer);
+
+	Benchmark::report("rulebase", "XML elements read",
+	                  elements / RULE_BASE_LOADS, "elements");
+	Benchmark::report("rulebase", "XML read, no rules built",
+	                  readSeconds * 1e3 / RULE_BASE_LOADS, "ms/load");
+	Benchmark::report("rulebase", "rule sets loaded",
+	                  ruleSets / RULE_BASE_LOADS, "sets");
+	Benchmark::report("rulebase", "compiled tables, indexed",
+	                  loadSeconds * 1e3 / RULE_BASE_LOADS, "ms/load");
+}
@@ -0,0 +1,158 @@
+#include "benchmark.hpp"
+#include "AST.hpp"
+#include "formulaparser.hpp"
+#include "statementvisitor.hpp"
+#include "statementwalker.hpp"
+
+#define FORMULA_COUNT 100000
+#define MAX_FORMULA_SIZE 40
+#define VARIABLE_COUNT 8
+#define REPEATS 10
+
+using namespace AST;
+
+/* A per node pass that needs the concrete class, weighing nodes by kind */
+class NodeWeigher : public StatementVisitor<NodeWeigher, int>
+{
+  public:
+	int visitStatement(LogicStatement *)
+	{
+		return 1;
+	}
+
+	int visitNot(NotStatement *)
+	{
+		return 2;
+	}
+
+	int visitAnd(AndStatement *)
+	{
+		return 3;
+	}
+
+	int visitOr(OrStatement *)
+	{
+		return 4;
+	}
+
+	int visitImplies(ImpliesStatement *)
+	{
+		return 5;
+	}
+
+	int visitIff(IffStatement *)
+	{
+		return 6;
+	}
+};
+
+/* The same weights found by trying the classes in turn, as the passes did
+ * before they dispatched on the symbol */
+static int castWeight(LogicStatement *statement)
+{
+	if (dynamic_cast<NotStatement *>(statement))
+		return 2;
+	if (dynamic_cast<AndStatement *>(statement))
+		return 3;
+	if (dynamic_cast<OrStatement *>(statement))
+		return 4;
+	if (dynamic_cast<ImpliesStatement *>(statement))
+		return 5;
+	if (dynamic_cast<IffStatement *>(statement))
+		return 6;
+	return 1;
+}
+
+static long long castRecursion(LogicStatement *statement)
+{
+	long long weight = castWeight(statement);
+
+	if (UnaryOpStatement *unary = dynamic_cast<UnaryOpStatement *>(statement))
+		return weight + castRecursion(unary->getStatement());
+
+	if (BinaryOpStatement *binary =
+	        dynamic_cast<BinaryOpStatement *>(statement))
+		return weight + castRecursion(binary->getLeftStatement()) +
+		       castRecursion(binary->getRightStatement());
+
+	return weight;
+}
+
+static long long castWalk(LogicStatement *root)
+{
+	long long weight = 0;
+
+	StatementWalker::walk(root, [&weight](LogicStatement *statement,
+	                                      int stage) {
+		if (stage == 0)
+			weight += castWeight(statement);
+		return StatementWalker::CONTINUE;
+	});
+
+	return weight;
+}
+
+static long long visitorWalk(LogicStatement *root)
+{
+	NodeWeigher weigher;
+	long long weight = 0;
+
+	StatementWalker::walk(root, [&weigher, &weight](LogicStatement *statement,
+	                                                int stage) {
+		if (stage == 0)
+			weight += weigher.visit(statement);
+		return StatementWalker::CONTINUE;
+	});
+
+	return weight;
+}
+
+/* Dispatch through StatementVisitor against dynamic_cast, both on the
+ * explicit stack walk and against the recursion it replaced */
+void visitorBenchmark()
+{
+	Benchmark input;
+	FormulaParser parser;
+	QVector<LogicStatement *> formulas;
+	long long nodes = 0;
+
+	for (int i = 0; i < FORMULA_COUNT; ++i) {
+		formulas.append(parser.parse(input.formula(
+		    input.next(MAX_FORMULA_SIZE) + 1, VARIABLE_COUNT)));
+		nodes += formulas.last()->nodeCount();
+	}
+
+	struct Pass
+	{
+		const char *name;
+		long long (*run)(LogicStatement *);
+	};
+
+	static const Pass PASSES[] = {
+	    {"dynamic_cast, recursion", castRecursion},
+	    {"dynamic_cast, walker", castWalk},
+	    {"StatementVisitor, walker", visitorWalk},
+	};
+
+	long long expected = -1;
+
+	for (const Pass &pass : PASSES) {
+		QElapsedTimer timer;
+		long long weight = 0;
+
+		timer.start();
+		for (int i = 0; i < REPEATS; ++i)
+			for (LogicStatement *formula : formulas)
+				weight += pass.run(formula);
+		double seconds = Benchmark::seconds(timer);
+
+		if (expected >= 0 && weight != expected)
+			Benchmark::report("visitor", "WRONG RESULT", 0, "");
+		expected = weight;
+
+		Benchmark::report("visitor", pass.name,
+		                  seconds * 1e9 / (nodes * REPEATS), "ns/node");
+	}
+
+	qDeleteAll(formulas);
+}
@@ -0,0 +1,303 @@
+#include "bitslicedevaluator.hpp"
+#include "symboltable.hpp"
+
+#include <QThreadPool>
+
+using namespace AST;
+
+/* Widest truth table swept, 2^22 blocks. Tables past PARALLEL_BLOCK_THRESHOLD
+ * are spread over the pool, so the limit sits well above it; the threads
+ * part of the bitsliced benchmark times the widest tables. Block numbers
+ * carry the variables past the sixth, so the limit also keeps them within a
+ * quint64 */
+#define TRUTH_TABLE_VARIABLE_LIMIT 28
+#define WORD_BITS 64
+#define LOG_WORD_BITS 6
+#define ALL_ROWS (~quint64(0))
+#define PARALLEL_BLOCK_THRESHOLD (1 << 12)
+#define MIN_CHUNK_BLOCKS (1 << 10)
+#define CHUNKS_PER_THREAD 8
+#define SIMULATION_SEED 0x9E3779B97F4A7C15ULL
+
+/* Truth table columns of the first six variables within one 64 row word */
+static const quint64 LOW_VARIABLE_PATTERN[LOG_WORD_BITS] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+
+QAtomicInt BitSlicedEvaluator::simulationCount(0);
+QAtomicInt BitSlicedEvaluator::refutationCount(0);
+
+BitSlicedEvaluator::BitSlicedEvaluator(LogicStatement *left,
+                                       LogicStatement *right)
+    : BitSlicedEvaluator(FlatFormula(left), FlatFormula(right))
+{
+}
+
+BitSlicedEvaluator::BitSlicedEvaluator(const FlatFormula &left,
+                                       const FlatFormula &right)
+{
+	/* Variables are numbered in order of first appearance, as
+	 * collectVariables reports them */
+	for (quint32 id : left.variables() + right.variables())
+		if (!variableIndex.contains(id)) {
+			variableIndex.insert(id, variableIndex.size());
+			variableNames.append(SymbolTable::globalTable()->spelling(id));
+		}
+
+	leftResult = compile(left);
+	rightResult = compile(right);
+}
+
+int BitSlicedEvaluator::variableCount()
+{
+	return variableIndex.size();
+}
+
+int BitSlicedEvaluator::addInstruction(Symbol opcode, int left, int right)
+{
+	program.append(Instruction{opcode, left, right});
+	return program.size() - 1;
+}
+
+int BitSlicedEvaluator::compile(const FlatFormula &formula)
+{
+	/* The formula is already in evaluation order, node i becomes
+	 * instruction base + i */
+	int base = program.size();
+	int n = formula.size();
+
+	for (int node = 0; node < n; ++node) {
+		Symbol opcode = formula.opcode(node);
+
+		if (opcode == VARIABLE_SYMBOL)
+			addInstruction(VARIABLE_SYMBOL,
+			               variableIndex.value(formula.symbolId(node)), 0);
+		else
+			addInstruction(opcode, base + formula.left(node),
+			               base + formula.right(node));
+	}
+
+	return base + formula.root();
+}
+
+void BitSlicedEvaluator::blockInputs(quint64 block, quint64 *inputs) const
+{
+	int count = variableIndex.size();
+
+	for (int index = 0; index < count && index < LOG_WORD_BITS; ++index)
+		inputs[index] = LOW_VARIABLE_PATTERN[index];
+
+	/* Higher variables are constant within a word, their value is taken from
+	 * the bits of the block number */
+	for (int index = LOG_WORD_BITS; index < count; ++index)
+		inputs[index] = ((block >> (index - LOG_WORD_BITS)) & 1) ? ALL_ROWS : 0;
+}
+
+quint64 BitSlicedEvaluator::difference(quint64 *value,
+                                       const quint64 *inputs) const
+{
+	const Instruction *code = program.constData();
+	int programSize = program.size();
+
+	for (int pc = 0; pc < programSize; ++pc) {
+		const Instruction &op = code[pc];
+
+		switch (op.opcode) {
+		case VARIABLE_SYMBOL:
+			value[pc] = inputs[op.left];
+			break;
+		case TRUTH_SYMBOL:
+			value[pc] = ALL_ROWS;
+			break;
+		case FALSITY_SYMBOL:
+			value[pc] = 0;
+			break;
+		case NOT_SYMBOL:
+			value[pc] = ~value[op.left];
+			break;
+		case AND_SYMBOL:
+			value[pc] = value[op.left] & value[op.right];
+			break;
+		case OR_SYMBOL:
+			value[pc] = value[op.left] | value[op.right];
+			break;
+		case IMPLIES_SYMBOL:
+			value[pc] = ~value[op.left] | value[op.right];
+			break;
+		case IFF_SYMBOL:
+			value[pc] = ~(value[op.left] ^ value[op.right]);
+			break;
+		default:
+			value[pc] = 0;
+		}
+	}
+
+	return value[leftResult] ^ value[rightResult];
+}
+
+void BitSlicedEvaluator::readAssignment(const quint64 *inputs, quint64 rows,
+                                        QMap<QString, bool> *assignment) const
+{
+	/* Isolate the lowest differing row */
+	quint64 row = rows & (~rows + 1);
+
+	assignment->clear();
+	for (int index = 0; index < variableNames.size(); ++index)
+		assignment->insert(variableNames.at(index), inputs[index] & row);
+}
+
+quint64 BitSlicedEvaluator::blockCount() const
+{
+	int count = variableIndex.size();
+	return count > LOG_WORD_BITS ? quint64(1) << (count - LOG_WORD_BITS) : 1;
+}
+
+bool BitSlicedEvaluator::sweepBlocks(quint64 first, quint64 last,
+                                     QAtomicInt *differs,
+                                     quint64 *differingBlock,
+                                     quint64 *differingRows) const
+{
+	int count = variableIndex.size();
+
+	/* With fewer than six variables only the low 2^n rows are meaningful */
+	quint64 validRows = count >= LOG_WORD_BITS
+	                        ? ALL_ROWS
+	                        : (quint64(1) << (1 << count)) - 1;
+
+	/* Every worker owns its operand slots, the AST is never written */
+	QVector<quint64> words(program.size());
+	QVector<quint64> inputs(count);
+
+	*differingRows = 0;
+
+	for (quint64 block = first; block < last; ++block) {
+		if (differs && differs->load())
+			return false;
+
+		blockInputs(block, inputs.data());
+		quint64 rows = difference(words.data(), inputs.constData()) & validRows;
+
+		if (rows) {
+			*differingBlock = block;
+			*differingRows = rows;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BitSlicedEvaluator::Sweep::work()
+{
+	evaluator->sweepChunks(this);
+}
+
+void BitSlicedEvaluator::sweepChunks(Sweep *sweep) const
+{
+	quint64 totalBlocks = blockCount();
+
+	for (;;) {
+		quint64 chunk = quint64(sweep->nextChunk.fetchAndAddRelaxed(1));
+
+		if (chunk >= sweep->chunkCount || sweep->differs.load())
+			return;
+
+		quint64 first = totalBlocks * chunk / sweep->chunkCount;
+		quint64 last = totalBlocks * (chunk + 1) / sweep->chunkCount;
+		quint64 block;
+		quint64 rows;
+
+		if (!sweepBlocks(first, last, &sweep->differs, &block, &rows)) {
+			/* Only the first worker to find a row reports it */
+			if (rows && sweep->differs.testAndSetOrdered(0, 1)) {
+				sweep->differingBlock = block;
+				sweep->differingRows = rows;
+			}
+			return;
+		}
+	}
+}
+
+bool BitSlicedEvaluator::isEquivalent(bool *equivalent,
+                                      QMap<QString, bool> *counterexample)
+{
+	if (variableCount() > TRUTH_TABLE_VARIABLE_LIMIT)
+		return false;
+
+	quint64 totalBlocks = blockCount();
+	int threads = QThreadPool::globalInstance()->maxThreadCount();
+	quint64 block;
+	quint64 rows;
+
+	*equivalent = true;
+
+	if (totalBlocks < PARALLEL_BLOCK_THRESHOLD || threads < 2) {
+		if (sweepBlocks(0, totalBlocks, nullptr, &block, &rows))
+			return true;
+	} else {
+		Sweep sweep;
+		sweep.evaluator = this;
+		sweep.chunkCount = qMin(totalBlocks / MIN_CHUNK_BLOCKS,
+		                        quint64(threads) * CHUNKS_PER_THREAD);
+		sweep.nextChunk.store(0);
+		sweep.differs.store(0);
+		sweep.run(threads - 1);
+
+		if (!sweep.differs.load())
+			return true;
+
+		block = sweep.differingBlock;
+		rows = sweep.differingRows;
+	}
+
+	*equivalent = false;
+
+	if (counterexample) {
+		QVector<quint64> inputs(variableIndex.size());
+		blockInputs(block, inputs.data());
+		readAssignment(inputs.constData(), rows, counterexample);
+	}
+
+	return true;
+}
+
+bool BitSlicedEvaluator::refute(int wordCount,
+                                QMap<QString, bool> *counterexample)
+{
+	QVector<quint64> words(program.size());
+	QVector<quint64> inputs(variableIndex.size());
+	quint64 state = SIMULATION_SEED;
+
+	simulationCount.fetchAndAddRelaxed(1);
+
+	for (int word = 0; word < wordCount; ++word) {
+		/* xorshift64* gives every variable an independent random column */
+		for (quint64 &input : inputs) {
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			input = state * 0x2545F4914F6CDD1DULL;
+		}
+
+		quint64 rows = difference(words.data(), inputs.constData());
+
+		if (rows) {
+			refutationCount.fetchAndAddRelaxed(1);
+			if (counterexample)
+				readAssignment(inputs.constData(), rows, counterexample);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int BitSlicedEvaluator::simulations()
+{
+	return simulationCount.load();
+}
+
+int BitSlicedEvaluator::refutations()
+{
+	return refutationCount.load();
+}
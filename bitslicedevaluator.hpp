@@ -0,0 +1,93 @@
+#ifndef BITSLICEDEVALUATOR_HPP
+#define BITSLICEDEVALUATOR_HPP
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include "AST.hpp"
+#include "flatformula.hpp"
+#include "paralleljob.hpp"
+
+/* Compiles two propositional formulas into one flat instruction list and
+ * evaluates them on 64 rows of the truth table at a time, each variable being
+ * a 64 bit word holding one bit per row. Large tables are split into chunks
+ * of blocks that are swept concurrently on the global thread pool */
+class BitSlicedEvaluator
+{
+	struct Instruction
+	{
+		Symbol opcode;
+		/* Operand slots, or the variable index for VARIABLE_SYMBOL */
+		int left;
+		int right;
+	};
+
+	/* Shared state of one concurrent sweep */
+	struct Sweep : ParallelJob
+	{
+		const BitSlicedEvaluator *evaluator;
+		quint64 chunkCount;
+		QAtomicInt nextChunk;
+		QAtomicInt differs;
+		/* Written once by the worker that raised differs */
+		quint64 differingBlock;
+		quint64 differingRows;
+
+		void work();
+	};
+
+	QVector<Instruction> program;
+	QHash<quint32, int> variableIndex;
+	QVector<QString> variableNames;
+	int leftResult;
+	int rightResult;
+
+	static QAtomicInt simulationCount;
+	static QAtomicInt refutationCount;
+
+	int compile(const FlatFormula &formula);
+	int addInstruction(Symbol opcode, int left, int right);
+	quint64 blockCount() const;
+	void blockInputs(quint64 block, quint64 *inputs) const;
+
+	/* Runs the program on one word of rows, returning the rows on which
+	 * the formulas differ */
+	quint64 difference(quint64 *value, const quint64 *inputs) const;
+
+	/* Returns false as soon as a row in blocks [first, last) tells the
+	 * formulas apart, or when differs is raised by another worker */
+	bool sweepBlocks(quint64 first, quint64 last, QAtomicInt *differs,
+	                 quint64 *differingBlock, quint64 *differingRows) const;
+
+	/* Claims chunks of the sweep until none are left or one differs */
+	void sweepChunks(Sweep *sweep) const;
+
+	/* Reads the assignment of the lowest differing row */
+	void readAssignment(const quint64 *inputs, quint64 rows,
+	                    QMap<QString, bool> *assignment) const;
+
+  public:
+	BitSlicedEvaluator(AST::LogicStatement *left, AST::LogicStatement *right);
+	BitSlicedEvaluator(const FlatFormula &left, const FlatFormula &right);
+
+	/* Number of distinct variables over both formulas */
+	int variableCount();
+
+	/* Sets equivalent and returns true unless the truth table is too wide
+	 * to sweep. Formulas that differ fill counterexample, when given, with
+	 * an assignment telling them apart */
+	bool isEquivalent(bool *equivalent,
+	                  QMap<QString, bool> *counterexample = nullptr);
+
+	/* Evaluates both formulas on wordCount words of pseudo random rows,
+	 * returns true and fills counterexample, when given, if one differs */
+	bool refute(int wordCount, QMap<QString, bool> *counterexample = nullptr);
+
+	/* Number of calls to refute and how many of them found a difference */
+	static int simulations();
+	static int refutations();
+};
+
+#endif // BITSLICEDEVALUATOR_HPP
@@ -0,0 +1,123 @@
+#include "discriminationtree.hpp"
+#include "AST.hpp"
+#include "statementwalker.hpp"
+
+using namespace AST;
+
+/* Symbol and number of children, so parameter lists of different lengths
+ * take different edges */
+static inline quint32 nodeKey(LogicStatement *statement)
+{
+	int children = 0;
+
+	while (statement->getChild(children) != nullptr)
+		++children;
+
+	return quint32(statement->getSymbol()) << 2 | quint32(children);
+}
+
+DiscriminationTree::DiscriminationTree()
+{
+	addNode();
+}
+
+int DiscriminationTree::addNode()
+{
+	Node node;
+	node.wildcard = -1;
+	nodes.append(node);
+	return nodes.size() - 1;
+}
+
+int DiscriminationTree::child(int node, quint32 key) const
+{
+	for (const QPair<quint32, int> &edge : nodes.at(node).edges)
+		if (edge.first == key)
+			return edge.second;
+
+	return -1;
+}
+
+void DiscriminationTree::insert(LogicStatement *rule, int value)
+{
+	int node = 0;
+
+	StatementWalker::walk(rule, [this, &node](LogicStatement *statement,
+	                                          int stage) {
+		if (stage > 0)
+			return StatementWalker::CONTINUE;
+
+		int next;
+
+		if (statement->getSymbol() == VARIABLE_SYMBOL) {
+			next = nodes.at(node).wildcard;
+			if (next < 0) {
+				next = addNode();
+				nodes[node].wildcard = next;
+			}
+			node = next;
+			return StatementWalker::SKIP_CHILDREN;
+		}
+
+		quint32 key = nodeKey(statement);
+
+		next = child(node, key);
+		if (next < 0) {
+			next = addNode();
+			nodes[node].edges.append(qMakePair(key, next));
+		}
+		node = next;
+		return StatementWalker::CONTINUE;
+	});
+
+	nodes[node].entries.append(Entry(rule, value));
+}
+
+QVector<DiscriminationTree::Entry>
+DiscriminationTree::candidates(LogicStatement *input) const
+{
+	/* Input in prefix order, with where the subformula of each node ends */
+	QVector<quint32> keys;
+	QVector<int> ends;
+	QVector<int> open;
+
+	StatementWalker::walk(input, [&keys, &ends, &open](
+	                                 LogicStatement *statement, int stage) {
+		if (stage == 0) {
+			open.append(keys.size());
+			keys.append(nodeKey(statement));
+			ends.append(0);
+		}
+		if (statement->getChild(stage) == nullptr)
+			ends[open.takeLast()] = keys.size();
+
+		return StatementWalker::CONTINUE;
+	});
+
+	/* Every path matching a prefix of the input, as a tree node and the
+	 * position in the input it is at. A rule path cannot be walked twice,
+	 * so every rule is reached at most once */
+	QVector<Entry> found;
+	QVector<QPair<int, int> > pending;
+
+	pending.append(qMakePair(0, 0));
+	while (!pending.isEmpty()) {
+		QPair<int, int> next = pending.takeLast();
+		const Node &node = nodes.at(next.first);
+		int position = next.second;
+
+		if (position == keys.size()) {
+			found += node.entries;
+			continue;
+		}
+
+		if (node.wildcard >= 0)
+			pending.append(qMakePair(node.wildcard, ends.at(position)));
+
+		int exact = child(next.first, keys.at(position));
+		if (exact >= 0)
+			pending.append(qMakePair(exact, position + 1));
+	}
+
+	return found;
+}
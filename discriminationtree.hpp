@@ -0,0 +1,48 @@
+#ifndef DISCRIMINATIONTREE_HPP
+#define DISCRIMINATIONTREE_HPP
+
+#include <QPair>
+#include <QVector>
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* Index of rules by shape. A rule is read in prefix order as the symbols
+ * and child counts of its nodes, with each rule variable read as a
+ * wildcard, and stored along that path. A walk of an input then follows
+ * its own symbols and, at wildcards, skips a whole subformula, reaching the
+ * rules whose non variable nodes line up with the input. Those are the only
+ * rules that can match it, which repeated variables may still rule out */
+class DiscriminationTree
+{
+  public:
+	/* Rule with what it was inserted with */
+	typedef QPair<AST::LogicStatement *, int> Entry;
+
+  private:
+	struct Node
+	{
+		/* Child per node key, in order of insertion */
+		QVector<QPair<quint32, int> > edges;
+		/* Child reached through a rule variable, -1 when there is none */
+		int wildcard;
+		QVector<Entry> entries;
+	};
+
+	QVector<Node> nodes;
+
+	int addNode();
+	int child(int node, quint32 key) const;
+
+  public:
+	DiscriminationTree();
+
+	void insert(AST::LogicStatement *rule, int value);
+
+	/* Rules whose shape fits input, each once */
+	QVector<Entry> candidates(AST::LogicStatement *input) const;
+};
+
+#endif // DISCRIMINATIONTREE_HPP
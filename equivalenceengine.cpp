@@ -1,9 +1,23 @@
 #include "equivalenceengine.hpp"
+#include "arena.hpp"
+
+#include <algorithm>
 
 EquivalenceEngine::EquivalenceEngine()
 {
 	ruleEngine = new RuleEngine();
 	rules = ruleEngine->parseRuleXml();
+
+	for (int i = 0; i < rules->size(); ++i)
+		indexRuleSet(i);
+}
+
+void EquivalenceEngine::indexRuleSet(int index)
+{
+	for (Rule *rule : *rules->at(index)->getSet()) {
+		ruleShapes.insert(rule, index);
+		flatRules.insert(rule, FlatFormula(rule));
+	}
 }
 
 EquivalenceEngine::~EquivalenceEngine()
@@ -30,14 +44,43 @@ EquivalenceUtility *EquivalenceEngine::tryMatchRule(LogicStatement *formula,
 	return nullptr;
 }
 
+bool EquivalenceEngine::mayMatch(Rule *rule, const FlatFormula &input)
+{
+	return FlatFormula::mayMatch(flatRules.constFind(rule).value(), input);
+}
+
 QVector<LogicSet *> *EquivalenceEngine::match(LogicStatement *input)
 {
 
 	auto relatedEquivalence = new QVector<LogicSet *>();
+	FlatFormula flatInput(input);
+
+	/* Sets without a rule of the right shape cannot apply */
+	QSet<Rule *> candidates;
+	QVector<int> candidateSets;
 
-	for (LogicSet *ruleSet : *rules)
-		if (ruleApplicable(input, ruleSet))
-			relatedEquivalence->append(ruleSet);
+	for (const DiscriminationTree::Entry &entry :
+	     ruleShapes.candidates(input)) {
+		candidates.insert(entry.first);
+		candidateSets.append(entry.second);
+	}
+
+	/* In the order of the rule base */
+	std::sort(candidateSets.begin(), candidateSets.end());
+	candidateSets.erase(
+	    std::unique(candidateSets.begin(), candidateSets.end()),
+	    candidateSets.end());
+
+	/* Matching utilities, their tables and sets die before returning */
+	{
+		Arena arena;
+		ArenaScope scope(&arena);
+
+		for (int index : candidateSets)
+			if (ruleApplicable(input, flatInput, rules->at(index),
+			                   candidates))
+				relatedEquivalence->append(rules->at(index));
+	}
 
 	return relatedEquivalence;
 }
@@ -46,11 +89,15 @@ QVector<Rule *> *EquivalenceEngine::getMatchedRules(LogicStatement *input,
                                                     LogicSet *ruleSet)
 {
 	auto matchedRules = new QVector<Rule *>();
+	FlatFormula flatInput(input);
 
 	EquivalenceUtility *matchingResult;
+	Arena arena;
+	ArenaScope scope(&arena);
 
 	for (Rule *rule : *ruleSet->getSet()) {
-		matchingResult = tryMatchRule(input, rule);
+		matchingResult =
+		    mayMatch(rule, flatInput) ? tryMatchRule(input, rule) : nullptr;
 		if (matchingResult != nullptr) {
 			matchedRules->append(rule);
 			delete matchingResult;
@@ -63,6 +110,19 @@ QVector<Rule *> *EquivalenceEngine::getMatchedRules(LogicStatement *input,
 	return matchedRules;
 }
 
+/* Returns a newly allocated instance of rule with its variables replaced
+ * by their values in idTable. The substitution runs on the formula graph,
+ * so the values are interned once and shared by every occurrence of their
+ * variable instead of being cloned for each */
+static LogicStatement *instantiate(Rule *rule, IDTable *idTable)
+{
+	for (QPair<Variable *, LogicStatement *> *pair : *idTable->getMapping())
+		idTable->add(Formula::fromStatement(pair->first),
+		             Formula::fromStatement(pair->second));
+
+	return Formula::fromStatement(rule).replaced(idTable).toStatement();
+}
+
 LogicStatement *EquivalenceEngine::replaceStatement(LogicStatement *formula,
                                                     Rule *baseRule,
                                                     Rule *transformationRule,
@@ -89,7 +149,7 @@ LogicStatement *EquivalenceEngine::replaceStatement(LogicStatement *formula,
 		    getQualifiedBoundVariable(formula, boundVariable, UI);
 		idTable->add(boundVariable, userdefinedVariable);
 
-		result = transformationRule->clone()->replace(idTable);
+		result = instantiate(transformationRule, idTable);
 		delete userdefinedVariable;
 		delete formula;
 		delete matchingUtility;
@@ -106,6 +166,7 @@ LogicStatement *EquivalenceEngine::replaceStatement(LogicStatement *formula,
 
 		for (Variable *freeVariable : *freeVariableList)
 			freeVariable->setName(newName);
+		formula->invalidateSummaries();
 
 		delete userdefinedVariable;
 		delete matchingUtility;
@@ -135,7 +196,7 @@ LogicStatement *EquivalenceEngine::replaceStatement(LogicStatement *formula,
 	}
 
 	/* No further input for patterns required */
-	result = transformationRule->clone()->replace(idTable);
+	result = instantiate(transformationRule, idTable);
 	delete matchingUtility;
 	delete formula;
 	delete undefinedVariableSet;
@@ -143,13 +204,30 @@ LogicStatement *EquivalenceEngine::replaceStatement(LogicStatement *formula,
 	return result;
 }
 
-bool EquivalenceEngine::ruleApplicable(LogicStatement *input, LogicSet *ruleSet)
+LogicStatement *EquivalenceEngine::replaceStatement(
+    LogicStatement *root, const FormulaPath &path, Rule *baseRule,
+    Rule *transformationRule, SolutionTabWidget *userWindow)
+{
+	LogicStatement *replacement = replaceStatement(
+	    path.get(root), baseRule, transformationRule, userWindow);
+
+	return path.replace(root, replacement);
+}
+
+bool EquivalenceEngine::ruleApplicable(LogicStatement *input,
+                                       const FlatFormula &flatInput,
+                                       LogicSet *ruleSet,
+                                       const QSet<Rule *> &candidates)
 {
 	EquivalenceUtility *matchingResult;
 	QVector<Rule *> rulesMatched;
 
+	/* Rules after a leibniz rule are never tried, candidates or not */
 	for (Rule *rule : *ruleSet->getSet()) {
-		matchingResult = tryMatchRule(input, rule);
+		matchingResult =
+		    candidates.contains(rule) && mayMatch(rule, flatInput)
+		        ? tryMatchRule(input, rule)
+		        : nullptr;
 
 		if (matchingResult != nullptr) {
 			delete matchingResult;
@@ -261,5 +339,15 @@ LogicStatement *EquivalenceEngine::getAnyFormula(QString &prefixMessage,
 bool EquivalenceEngine::addNewPropositionalEquivalence(
     LogicStatement *rawFormulaFrom, LogicStatement *rawFormulaTo)
 {
-	return ruleEngine->addRule(rawFormulaFrom, rawFormulaTo);
+	if (!ruleEngine->addRule(rawFormulaFrom, rawFormulaTo))
+		return false;
+
+	indexRuleSet(rules->size() - 1);
+	return true;
+}
+
+bool EquivalenceEngine::knowsEquivalence(LogicStatement *rawFormulaFrom,
+                                         LogicStatement *rawFormulaTo)
+{
+	return ruleEngine->knowsRule(rawFormulaFrom, rawFormulaTo);
 }
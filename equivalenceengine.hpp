@@ -1,19 +1,34 @@
 #ifndef EQUIVALENCEENGINE_H
 #define EQUIVALENCEENGINE_H
 
+#include "discriminationtree.hpp"
 #include "equivalenceutility.hpp"
+#include "flatformula.hpp"
+#include "formulapath.hpp"
 #include "solutiontabwidget.hpp"
 #include "ruleengine.hpp"
 #include "utility.hpp"
 
+#include <QSet>
+
 using namespace AST;
 
 class EquivalenceEngine
 {
   private:
 	QVector<LogicSet *> *rules;
-	bool ruleApplicable(LogicStatement *, LogicSet *);
+	/* Every rule by shape, with the index of its set in rules */
+	DiscriminationTree ruleShapes;
+	/* Flat copy of every rule, made along with its shape. Rules are only
+	 * freed with the engine, so the keys never dangle */
+	QHash<Rule *, FlatFormula> flatRules;
+	void indexRuleSet(int index);
+	/* Only rules among candidates are tried */
+	bool ruleApplicable(LogicStatement *, const FlatFormula &, LogicSet *,
+	                    const QSet<Rule *> &candidates);
 	EquivalenceUtility *tryMatchRule(LogicStatement *, Rule *);
+	/* Cheap structural test run before tryMatchRule */
+	bool mayMatch(Rule *rule, const FlatFormula &input);
 	bool isVariable(LogicStatement *statement);
 	bool acceptedRenamedVariable(LogicStatement *originalFormula,
 	                             Variable *userDefinedVariable);
@@ -51,12 +66,24 @@ class EquivalenceEngine
 	                                 Rule *baseRule, Rule *transformationRule,
 	                                 SolutionTabWidget *userWindow);
 
+	/* Same as above on the subformula of root at path, which is rewritten in
+	 * place. Returns the new root */
+	LogicStatement *replaceStatement(LogicStatement *root,
+	                                 const FormulaPath &path, Rule *baseRule,
+	                                 Rule *transformationRule,
+	                                 SolutionTabWidget *userWindow);
+
 	/* Function for user defined rules, note both rules must be proven to be
 	 * equivalent and returns true if both are propositional
 	 * and successfully added and false if already
 	 * exists or is First order */
 	bool addNewPropositionalEquivalence(LogicStatement *rawFormulaFrom,
 	                                    LogicStatement *rawFormulaTo);
+
+	/* Returns true iff the rule base already holds the equivalence, up to a
+	 * renaming of its variables */
+	bool knowsEquivalence(LogicStatement *rawFormulaFrom,
+	                      LogicStatement *rawFormulaTo);
 };
 
 #endif // EQUIVALENCEENGINE_H
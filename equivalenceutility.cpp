@@ -1,4 +1,5 @@
 #include "equivalenceutility.hpp"
+#include "arena.hpp"
 
 EquivalenceUtility::EquivalenceUtility()
 {
@@ -12,6 +13,16 @@ EquivalenceUtility::~EquivalenceUtility()
 	deleteAuxiliaryItems();
 }
 
+void *EquivalenceUtility::operator new(size_t size)
+{
+	return Arena::allocate(size);
+}
+
+void EquivalenceUtility::operator delete(void *memory)
+{
+	Arena::release(memory);
+}
+
 void EquivalenceUtility::deleteAuxiliaryItems()
 {
 
@@ -35,6 +35,10 @@ class EquivalenceUtility
   public:
 	EquivalenceUtility();
 	~EquivalenceUtility();
+
+	/* Placed in the current arena when there is one */
+	static void *operator new(size_t size);
+	static void operator delete(void *memory);
 	void initFreeVariableList();
 	void initRejectionBoundVariableSet(Variable *boundedVariable);
 	QVector<Variable *> *getFreeVariableList();
@@ -0,0 +1,208 @@
+#include "flatformula.hpp"
+#include "AST.hpp"
+#include "statementwalker.hpp"
+
+#include <QPair>
+#include <cstring>
+
+using namespace AST;
+
+static inline uint combine(uint seed, uint value)
+{
+	return seed ^ (value + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+}
+
+/* Compares n entries of two arrays ending at the given indices */
+template <typename T>
+static inline bool rangeEquals(const QVector<T> &a, int aEnd,
+                               const QVector<T> &b, int bEnd, int n)
+{
+	return memcmp(a.constData() + aEnd - n + 1, b.constData() + bEnd - n + 1,
+	              n * sizeof(T)) == 0;
+}
+
+FlatFormula::FlatFormula()
+{
+}
+
+FlatFormula::FlatFormula(LogicStatement *statement)
+{
+	append(statement);
+}
+
+int FlatFormula::appendNode(Symbol opcode, int left, int right,
+                            quint32 symbolId)
+{
+	int node = opcodes.size();
+	uint hash = combine(uint(opcode), symbolId);
+	quint32 size = 1;
+
+	hash = combine(hash, left < 0 ? 0 : hashes.at(left));
+	hash = combine(hash, right < 0 ? 0 : hashes.at(right));
+	size += left < 0 ? 0 : sizes.at(left);
+	size += right < 0 ? 0 : sizes.at(right);
+
+	opcodes.append(quint8(opcode));
+	leftOffsets.append(left < 0 ? 0 : quint32(node - left));
+	rightOffsets.append(right < 0 ? 0 : quint32(node - right));
+	symbolIds.append(symbolId);
+	sizes.append(size);
+	hashes.append(hash);
+
+	return node;
+}
+
+int FlatFormula::append(LogicStatement *statement)
+{
+	/* Indices of the appended nodes whose parent is not appended yet */
+	QVector<int> pending;
+
+	/* Nodes are appended once their last child is, i.e. in postorder */
+	StatementWalker::walk(statement, [this, &pending](LogicStatement *node,
+	                                                  int stage) {
+		if (node->getChild(stage) != nullptr)
+			return StatementWalker::CONTINUE;
+
+		int first = pending.size() - stage;
+		int left = stage > 0 ? pending.at(first) : -1;
+		int right = stage > 1 ? pending.at(first + 1) : -1;
+		quint32 symbolId = node->getSymbol() == VARIABLE_SYMBOL
+		                       ? static_cast<Variable *>(node)->getId()
+		                       : 0;
+
+		pending.resize(first);
+		pending.append(appendNode(node->getSymbol(), left, right, symbolId));
+		return StatementWalker::CONTINUE;
+	});
+
+	return pending.last();
+}
+
+int FlatFormula::size() const
+{
+	return opcodes.size();
+}
+
+int FlatFormula::root() const
+{
+	return opcodes.size() - 1;
+}
+
+Symbol FlatFormula::opcode(int node) const
+{
+	return Symbol(opcodes.at(node));
+}
+
+quint32 FlatFormula::symbolId(int node) const
+{
+	return symbolIds.at(node);
+}
+
+int FlatFormula::left(int node) const
+{
+	quint32 offset = leftOffsets.at(node);
+	return offset ? node - int(offset) : -1;
+}
+
+int FlatFormula::right(int node) const
+{
+	quint32 offset = rightOffsets.at(node);
+	return offset ? node - int(offset) : -1;
+}
+
+uint FlatFormula::hash() const
+{
+	return opcodes.isEmpty() ? 0 : hashes.last();
+}
+
+bool FlatFormula::operator==(const FlatFormula &other) const
+{
+	if (size() != other.size())
+		return false;
+
+	return size() == 0 || subtreeEquals(root(), other, other.root());
+}
+
+bool FlatFormula::subtreeEquals(int node, const FlatFormula &other,
+                                int otherNode) const
+{
+	int n = int(sizes.at(node));
+
+	if (n != int(other.sizes.at(otherNode)) ||
+	    hashes.at(node) != other.hashes.at(otherNode))
+		return false;
+
+	return rangeEquals(opcodes, node, other.opcodes, otherNode, n) &&
+	       rangeEquals(symbolIds, node, other.symbolIds, otherNode, n) &&
+	       rangeEquals(leftOffsets, node, other.leftOffsets, otherNode, n) &&
+	       rangeEquals(rightOffsets, node, other.rightOffsets, otherNode, n);
+}
+
+QVector<quint32> FlatFormula::variables() const
+{
+	QVector<quint32> ids;
+	const quint8 *code = opcodes.constData();
+	int n = size();
+
+	/* Leaves come in the same order in pre and postorder */
+	for (int node = 0; node < n; ++node)
+		if (code[node] == VARIABLE_SYMBOL && !ids.contains(symbolIds.at(node)))
+			ids.append(symbolIds.at(node));
+
+	return ids;
+}
+
+bool FlatFormula::mayMatch(const FlatFormula &rule, const FlatFormula &input)
+{
+	if (rule.size() == 0 || input.size() == 0)
+		return false;
+
+	QVector<QPair<int, int> > pending;
+	QVector<QPair<quint32, int> > bindings;
+
+	pending.append(qMakePair(rule.root(), input.root()));
+
+	while (!pending.isEmpty()) {
+		QPair<int, int> next = pending.takeLast();
+		int ruleNode = next.first;
+		int inputNode = next.second;
+
+		/* Rule variables stand for any subformula, the same one every time */
+		if (rule.opcodes.at(ruleNode) == VARIABLE_SYMBOL) {
+			quint32 id = rule.symbolIds.at(ruleNode);
+			bool bound = false;
+
+			for (const QPair<quint32, int> &binding : bindings)
+				if (binding.first == id) {
+					if (!input.subtreeEquals(binding.second, input, inputNode))
+						return false;
+					bound = true;
+					break;
+				}
+
+			if (!bound)
+				bindings.append(qMakePair(id, inputNode));
+			continue;
+		}
+
+		if (rule.opcodes.at(ruleNode) != input.opcodes.at(inputNode))
+			return false;
+
+		int ruleLeft = rule.left(ruleNode);
+		int ruleRight = rule.right(ruleNode);
+		int inputLeft = input.left(inputNode);
+		int inputRight = input.right(inputNode);
+
+		/* Only parameter lists of different lengths get here */
+		if ((ruleLeft < 0) != (inputLeft < 0) ||
+		    (ruleRight < 0) != (inputRight < 0))
+			return false;
+
+		if (ruleRight >= 0)
+			pending.append(qMakePair(ruleRight, inputRight));
+		if (ruleLeft >= 0)
+			pending.append(qMakePair(ruleLeft, inputLeft));
+	}
+
+	return true;
+}
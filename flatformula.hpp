@@ -0,0 +1,63 @@
+#ifndef FLATFORMULA_HPP
+#define FLATFORMULA_HPP
+
+#include <QVector>
+#include "symbol.hpp"
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* Formula laid out in postorder over parallel arrays, one entry per AST
+ * node. Children are laid out as in the AST: operands of connectives,
+ * quantified variable and body of quantifiers, predicate symbol and
+ * parameter list of predicates, first parameter and the rest of a parameter
+ * list, both sides of an equality. A child is referenced by its distance
+ * back from its parent and the subtree of a node is the run of entries
+ * ending at it, so equal subtrees are equal runs wherever they occur */
+class FlatFormula
+{
+	QVector<quint8> opcodes;
+	/* Distance back to the child, 0 when there is none */
+	QVector<quint32> leftOffsets;
+	QVector<quint32> rightOffsets;
+	/* SymbolTable id of variables, 0 for every other node */
+	QVector<quint32> symbolIds;
+	QVector<quint32> sizes;
+	QVector<uint> hashes;
+
+	int append(AST::LogicStatement *statement);
+	int appendNode(Symbol opcode, int left, int right, quint32 symbolId);
+
+  public:
+	FlatFormula();
+	explicit FlatFormula(AST::LogicStatement *statement);
+
+	int size() const;
+	int root() const;
+	Symbol opcode(int node) const;
+	quint32 symbolId(int node) const;
+
+	/* Index of the child, -1 when there is none */
+	int left(int node) const;
+	int right(int node) const;
+
+	/* Structural hash, the same for equal formulas */
+	uint hash() const;
+
+	/* Same notion of identity as equals() */
+	bool operator==(const FlatFormula &other) const;
+	bool subtreeEquals(int node, const FlatFormula &other, int otherNode) const;
+
+	/* Distinct variable ids in order of first appearance */
+	QVector<quint32> variables() const;
+
+	/* Returns false when rule cannot match input, i.e. when the non variable
+	 * nodes of rule do not line up with input or when a rule variable would
+	 * be bound to two different subformulas. Side conditions on free and
+	 * bound variables are left to LogicStatement::match */
+	static bool mayMatch(const FlatFormula &rule, const FlatFormula &input);
+};
+
+#endif // FLATFORMULA_HPP
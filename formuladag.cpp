@@ -0,0 +1,360 @@
+#include "formuladag.hpp"
+#include "AST.hpp"
+#include "idtable.hpp"
+#include "statementwalker.hpp"
+#include "symboltable.hpp"
+
+#include <QMutexLocker>
+#include <QVarLengthArray>
+
+using namespace AST;
+
+#define MIN_SWEEP_THRESHOLD (1 << 12)
+
+static inline uint combine(uint seed, uint value)
+{
+	return seed ^ (value + 0x9E3779B9u + (seed << 6) + (seed >> 2));
+}
+
+FormulaNode::FormulaNode(Symbol symbol, quint32 id, FormulaNode *left,
+                         FormulaNode *right, uint hash)
+    : symbol(symbol), id(id), left(left), right(right), hash(hash),
+      references(0)
+{
+	/* A node keeps its children alive */
+	if (left)
+		left->references.ref();
+	if (right)
+		right->references.ref();
+}
+
+Formula::Formula() : node(nullptr)
+{
+}
+
+Formula::Formula(FormulaNode *node) : node(node)
+{
+	if (node)
+		node->references.ref();
+}
+
+Formula::Formula(const Formula &other) : Formula(other.node)
+{
+}
+
+Formula &Formula::operator=(const Formula &other)
+{
+	if (other.node)
+		other.node->references.ref();
+	if (node)
+		node->references.deref();
+
+	node = other.node;
+	return *this;
+}
+
+Formula::~Formula()
+{
+	/* Unreferenced nodes are reclaimed by the next sweep of the graph */
+	if (node)
+		node->references.deref();
+}
+
+bool Formula::isNull() const
+{
+	return node == nullptr;
+}
+
+Symbol Formula::getSymbol() const
+{
+	return node->symbol;
+}
+
+quint32 Formula::getId() const
+{
+	return node->id;
+}
+
+const QString &Formula::getName() const
+{
+	return SymbolTable::globalTable()->spelling(node->id);
+}
+
+Formula Formula::getLeft() const
+{
+	return Formula(node->left);
+}
+
+Formula Formula::getRight() const
+{
+	return Formula(node->right);
+}
+
+uint Formula::hash() const
+{
+	return node ? node->hash : 0;
+}
+
+bool Formula::operator==(const Formula &other) const
+{
+	return node == other.node;
+}
+
+bool Formula::operator!=(const Formula &other) const
+{
+	return node != other.node;
+}
+
+Formula Formula::fromStatement(LogicStatement *statement)
+{
+	return FormulaDag::globalDag()->fromStatement(statement);
+}
+
+LogicStatement *Formula::toStatement() const
+{
+	return toStatement(node);
+}
+
+LogicStatement *Formula::toStatement(FormulaNode *node)
+{
+	struct Frame
+	{
+		FormulaNode *node;
+		bool expanded;
+	};
+
+	/* Post order on an explicit stack, as interned formulas can be as deep
+	 * as the statements they came from. A node is built once the
+	 * statements of its children are on top of built */
+	QVarLengthArray<Frame, 64> frames;
+	QVarLengthArray<LogicStatement *, 64> built;
+
+	frames.append(Frame{node, false});
+
+	while (!frames.isEmpty()) {
+		Frame &frame = frames.last();
+		FormulaNode *current = frame.node;
+
+		if (!frame.expanded) {
+			frame.expanded = true;
+			if (current->right)
+				frames.append(Frame{current->right, false});
+			if (current->left)
+				frames.append(Frame{current->left, false});
+			continue;
+		}
+
+		frames.removeLast();
+
+		LogicStatement *left = nullptr;
+		LogicStatement *right = nullptr;
+
+		if (current->right) {
+			right = built.last();
+			built.removeLast();
+		}
+		if (current->left) {
+			left = built.last();
+			built.removeLast();
+		}
+
+		built.append(toStatement(current, left, right));
+	}
+
+	return built.last();
+}
+
+LogicStatement *Formula::toStatement(FormulaNode *node, LogicStatement *left,
+                                     LogicStatement *right)
+{
+	switch (node->symbol) {
+	case VARIABLE_SYMBOL:
+		return new Variable(node->id);
+	case TRUTH_SYMBOL:
+		return new Truth();
+	case FALSITY_SYMBOL:
+		return new Falsity();
+	case NOT_SYMBOL:
+		return new NotStatement(left);
+	case AND_SYMBOL:
+		return new AndStatement(left, right);
+	case OR_SYMBOL:
+		return new OrStatement(left, right);
+	case IMPLIES_SYMBOL:
+		return new ImpliesStatement(left, right);
+	case IFF_SYMBOL:
+		return new IffStatement(left, right);
+	case FORALL_SYMBOL:
+		return new ForAllStatement(static_cast<Variable *>(left), right);
+	case THEREEXISTS_SYMBOL:
+		return new ThereExistsStatement(static_cast<Variable *>(left), right);
+	case PARAMETERS_SYMBOL:
+		return new Parameters(static_cast<Variable *>(left),
+		                      static_cast<Parameters *>(right));
+	case PREDICATE_SYMBOL:
+		return new PredicateSymbolStatement(new Variable(node->id),
+		                                    static_cast<Parameters *>(left));
+	case EQUALS_SYMBOL:
+		return new EqualityStatement(static_cast<Variable *>(left),
+		                             static_cast<Variable *>(right));
+	}
+
+	return nullptr;
+}
+
+Formula Formula::replaced(IDTable *idTable) const
+{
+	if (node == nullptr)
+		return *this;
+
+	if (node->symbol == VARIABLE_SYMBOL) {
+		Formula value = idTable->valueOf(*this);
+		return value.isNull() ? *this : value;
+	}
+
+	/* Only rules are replaced in, they are small enough to recurse on */
+	Formula left = getLeft().replaced(idTable);
+	Formula right = getRight().replaced(idTable);
+
+	if (left.node == node->left && right.node == node->right)
+		return *this;
+
+	return FormulaDag::globalDag()->make(node->symbol, node->id, left, right);
+}
+
+QString Formula::print(bool fullBracket) const
+{
+	LogicStatement *statement = toStatement();
+	QString text = statement->print(fullBracket);
+
+	delete statement;
+	return text;
+}
+
+FormulaDag::FormulaDag() : sweepThreshold(MIN_SWEEP_THRESHOLD)
+{
+}
+
+FormulaDag *FormulaDag::globalDag()
+{
+	static FormulaDag dag;
+	return &dag;
+}
+
+FormulaNode *FormulaDag::intern(Symbol symbol, quint32 id, FormulaNode *left,
+                                FormulaNode *right)
+{
+	uint hash = combine(combine(combine(uint(symbol), id),
+	                            left ? left->hash : 0),
+	                    right ? right->hash : 0);
+	FormulaKey key{symbol, id, left, right, hash};
+	FormulaNode *node = uniqueTable.value(key, nullptr);
+
+	if (node == nullptr) {
+		node = new FormulaNode(symbol, id, left, right, hash);
+		uniqueTable.insert(key, node);
+	}
+
+	return node;
+}
+
+FormulaNode *FormulaDag::build(LogicStatement *statement)
+{
+	/* Nodes built for children whose parent is not built yet */
+	QVector<FormulaNode *> pending;
+
+	StatementWalker::walk(statement, [this, &pending](LogicStatement *node,
+	                                                  int stage) {
+		if (node->getChild(stage) != nullptr)
+			return StatementWalker::CONTINUE;
+
+		Symbol symbol = node->getSymbol();
+		int first = pending.size() - stage;
+		FormulaNode *left = stage > 0 ? pending.at(first) : nullptr;
+		FormulaNode *right = stage > 1 ? pending.at(first + 1) : nullptr;
+		quint32 id = 0;
+
+		if (symbol == VARIABLE_SYMBOL)
+			id = static_cast<Variable *>(node)->getId();
+
+		/* The predicate symbol is kept as the id, the parameters are the
+		 * only child. The node built for the symbol is left to the sweep */
+		if (symbol == PREDICATE_SYMBOL) {
+			id = static_cast<PredicateSymbolStatement *>(node)
+			         ->getPredicateSymbol()
+			         ->getId();
+			left = right;
+			right = nullptr;
+		}
+
+		pending.resize(first);
+		pending.append(intern(symbol, id, left, right));
+		return StatementWalker::CONTINUE;
+	});
+
+	return pending.last();
+}
+
+Formula FormulaDag::make(Symbol symbol, quint32 id, const Formula &left,
+                         const Formula &right)
+{
+	QMutexLocker locker(&mutex);
+
+	if (uniqueTable.size() > sweepThreshold)
+		sweep();
+
+	return Formula(intern(symbol, id, left.node, right.node));
+}
+
+Formula FormulaDag::fromStatement(LogicStatement *statement)
+{
+	QMutexLocker locker(&mutex);
+
+	/* Freshly built nodes are unreferenced until their parent exists, so
+	 * sweeping only happens before a build starts */
+	if (uniqueTable.size() > sweepThreshold)
+		sweep();
+
+	return Formula(build(statement));
+}
+
+void FormulaDag::collectGarbage()
+{
+	QMutexLocker locker(&mutex);
+	sweep();
+}
+
+void FormulaDag::sweep()
+{
+	QVector<FormulaNode *> unreferenced;
+
+	/* Children of a live node are referenced by it, so the initial list
+	 * holds the roots of the dead part of the graph */
+	for (auto entry = uniqueTable.constBegin(); entry != uniqueTable.constEnd();
+	     ++entry)
+		if (entry.value()->references.load() == 0)
+			unreferenced.append(entry.value());
+
+	while (!unreferenced.isEmpty()) {
+		FormulaNode *node = unreferenced.takeLast();
+
+		uniqueTable.remove(
+		    FormulaKey{node->symbol, node->id, node->left, node->right,
+		               node->hash});
+
+		if (node->left && !node->left->references.deref())
+			unreferenced.append(node->left);
+		if (node->right && !node->right->references.deref())
+			unreferenced.append(node->right);
+
+		delete node;
+	}
+
+	sweepThreshold = qMax(MIN_SWEEP_THRESHOLD, 2 * uniqueTable.size());
+}
+
+int FormulaDag::nodeCount()
+{
+	QMutexLocker locker(&mutex);
+	return uniqueTable.size();
+}
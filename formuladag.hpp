@@ -0,0 +1,150 @@
+#ifndef FORMULADAG_HPP
+#define FORMULADAG_HPP
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include "symbol.hpp"
+
+namespace AST
+{
+class LogicStatement;
+}
+
+class IDTable;
+
+/* Immutable node of the shared formula graph. Children are laid out as in
+ * the AST: operands of connectives, quantified variable and body of
+ * quantifiers, parameter list of predicates, first parameter and the rest
+ * of a parameter list, both sides of an equality. Variables and predicates
+ * carry the SymbolTable id of their name */
+class FormulaNode
+{
+	friend class Formula;
+	friend class FormulaDag;
+
+	Symbol symbol;
+	/* 0 for every other node */
+	quint32 id;
+	FormulaNode *left;
+	FormulaNode *right;
+	uint hash;
+	QAtomicInt references;
+
+	FormulaNode(Symbol symbol, quint32 id, FormulaNode *left,
+	            FormulaNode *right, uint hash);
+};
+
+/* Reference counted handle on an interned node. Structurally identical
+ * formulas share one node, so comparing handles compares pointers and
+ * copying a handle copies no formula */
+class Formula
+{
+	friend class FormulaDag;
+
+	FormulaNode *node;
+
+	/* Takes a new reference on node */
+	explicit Formula(FormulaNode *node);
+
+	static AST::LogicStatement *toStatement(FormulaNode *node);
+	/* Builds node alone from the statements built for its children */
+	static AST::LogicStatement *toStatement(FormulaNode *node,
+	                                        AST::LogicStatement *left,
+	                                        AST::LogicStatement *right);
+
+  public:
+	Formula();
+	Formula(const Formula &other);
+	Formula &operator=(const Formula &other);
+	~Formula();
+
+	bool isNull() const;
+	Symbol getSymbol() const;
+	quint32 getId() const;
+	const QString &getName() const;
+	Formula getLeft() const;
+	Formula getRight() const;
+
+	/* Structural hash, equal for equal formulas. Names enter it as their
+	 * ids, so it differs between runs */
+	uint hash() const;
+
+	bool operator==(const Formula &other) const;
+	bool operator!=(const Formula &other) const;
+
+	/* Interns a statement, with the same notion of identity as equals() */
+	static Formula fromStatement(AST::LogicStatement *statement);
+
+	/* Returns a newly allocated AST for the formula */
+	AST::LogicStatement *toStatement() const;
+
+	/* Same as LogicStatement::replace on the handle mapping of idTable,
+	 * for rules: every variable with a value there is replaced by it,
+	 * others are kept. Values are shared, not copied, so the work is
+	 * bounded by the size of the rule */
+	Formula replaced(IDTable *idTable) const;
+
+	QString print(bool fullBracket) const;
+
+};
+
+inline uint qHash(const Formula &formula, uint seed = 0)
+{
+	return formula.hash() ^ seed;
+}
+
+struct FormulaKey
+{
+	Symbol symbol;
+	quint32 id;
+	FormulaNode *left;
+	FormulaNode *right;
+	uint hash;
+
+	bool operator==(const FormulaKey &other) const
+	{
+		return symbol == other.symbol && id == other.id &&
+		       left == other.left && right == other.right;
+	}
+};
+
+inline uint qHash(const FormulaKey &key, uint seed = 0)
+{
+	return key.hash ^ seed;
+}
+
+/* Unique table behind the handles. Nodes nobody refers to any more stay in
+ * the table until the next sweep, so a formula that is built again soon
+ * after being dropped is found instead of allocated */
+class FormulaDag
+{
+	QHash<FormulaKey, FormulaNode *> uniqueTable;
+	int sweepThreshold;
+	QMutex mutex;
+
+	FormulaDag();
+
+	FormulaNode *intern(Symbol symbol, quint32 id, FormulaNode *left,
+	                    FormulaNode *right);
+	FormulaNode *build(AST::LogicStatement *statement);
+	void sweep();
+
+  public:
+	/* Shared graph for the whole application */
+	static FormulaDag *globalDag();
+
+	Formula make(Symbol symbol, quint32 id = 0,
+	             const Formula &left = Formula(),
+	             const Formula &right = Formula());
+
+	Formula fromStatement(AST::LogicStatement *statement);
+
+	/* Frees every node no handle refers to */
+	void collectGarbage();
+
+	int nodeCount();
+};
+
+#endif // FORMULADAG_HPP
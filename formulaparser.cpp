@@ -0,0 +1,529 @@
+#include "formulaparser.hpp"
+#include "AST.hpp"
+#include "symbol.hpp"
+#include "symboltable.hpp"
+
+#include <QVarLengthArray>
+
+using namespace AST;
+
+enum TokenKind {
+	END_TOKEN,
+	UNKNOWN_TOKEN,
+	IDENTIFIER_TOKEN,
+	LBRACKET_TOKEN,
+	RBRACKET_TOKEN,
+	COMMA_TOKEN,
+	EQUALS_TOKEN,
+	NOT_TOKEN,
+	AND_TOKEN,
+	OR_TOKEN,
+	IMPLIES_TOKEN,
+	IFF_TOKEN,
+	TRUTH_TOKEN,
+	FALSITY_TOKEN,
+	FORALL_TOKEN,
+	THEREEXISTS_TOKEN
+};
+
+struct Token
+{
+	TokenKind kind;
+	int start;
+	int length;
+};
+
+/* Connective, bracket or quantifier waiting for its operands */
+struct Pending
+{
+	TokenKind kind;
+	/* Quantified variable of a quantifier */
+	Variable *variable;
+};
+
+/* Connectives bind tighter the higher their power, brackets and
+ * quantifiers are only closed by a bracket */
+static int bindingPower(TokenKind kind)
+{
+	switch (kind) {
+	case IFF_TOKEN:
+		return 1;
+	case IMPLIES_TOKEN:
+		return 2;
+	case OR_TOKEN:
+		return 3;
+	case AND_TOKEN:
+		return 4;
+	case NOT_TOKEN:
+		return 5;
+	default:
+		return 0;
+	}
+}
+
+/* Reads the code point at offset at, setting length to its number of code
+ * units. Unpaired surrogates and malformed UTF-8 come out as code points
+ * no token starts with */
+static inline uint codePoint(const QChar *text, int, int at, int *length)
+{
+	*length = 1;
+	return text[at].unicode();
+}
+
+/* Smallest code point each sequence length may encode, shorter forms of
+ * the same point are overlong */
+static const uint UTF8_MINIMUM[] = {0, 0, 0x80, 0x800, 0x10000};
+
+static inline uint codePoint(const char *text, int size, int at, int *length)
+{
+	uchar lead = uchar(text[at]);
+
+	*length = 1;
+	if (lead < 0x80)
+		return lead;
+
+	/* A continuation byte cannot start a sequence */
+	if (lead < 0xC0 || lead >= 0xF8)
+		return 0xFFFD;
+
+	int count = lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+	uint point = lead & (0x7F >> count);
+
+	while (*length < count && at + *length < size &&
+	       (uchar(text[at + *length]) & 0xC0) == 0x80)
+		point = (point << 6) | (uchar(text[at + (*length)++]) & 0x3F);
+
+	if (*length != count || point < UTF8_MINIMUM[count] ||
+	    point > 0x10FFFF || (point >= 0xD800 && point <= 0xDFFF))
+		return 0xFFFD;
+
+	return point;
+}
+
+static inline quint32 internIdentifier(const QChar *text, int length)
+{
+	return SymbolTable::globalTable()->intern(text, length);
+}
+
+/* Identifiers are ASCII, widened on the stack */
+static inline quint32 internIdentifier(const char *text, int length)
+{
+	QVarLengthArray<QChar, 32> spelling;
+
+	for (int index = 0; index < length; ++index)
+		spelling.append(QChar(uchar(text[index])));
+
+	return SymbolTable::globalTable()->intern(spelling.constData(), length);
+}
+
+static inline QString spelling(const QChar *text, int length)
+{
+	return QString(text, length);
+}
+
+static inline QString spelling(const char *text, int length)
+{
+	return QString::fromUtf8(text, length);
+}
+
+static inline bool isLetter(uint point)
+{
+	return (point >= 'a' && point <= 'z') || (point >= 'A' && point <= 'Z');
+}
+
+static inline bool isDigit(uint point)
+{
+	return point >= '0' && point <= '9';
+}
+
+template <class Unit>
+class PrecedenceParser
+{
+	const Unit *text;
+	int size;
+	/* Offset of the first code unit not scanned yet */
+	int cursor;
+	Token token;
+
+	QVarLengthArray<LogicStatement *, 64> operands;
+	QVarLengthArray<Pending, 64> pending;
+
+	QString *message;
+	int *position;
+
+	void next();
+	bool fail();
+	bool expect(TokenKind kind);
+	void reduce(int power);
+	bool parseAtom();
+
+  public:
+	PrecedenceParser(const Unit *text, int size, QString *message,
+	                 int *position)
+	    : text(text), size(size), cursor(0), message(message),
+	      position(position)
+	{
+	}
+
+	~PrecedenceParser();
+
+	LogicStatement *parse();
+};
+
+template <class Unit>
+PrecedenceParser<Unit>::~PrecedenceParser()
+{
+	/* Whatever is left was built before an error */
+	for (LogicStatement *operand : operands)
+		delete operand;
+
+	for (const Pending &waiting : pending)
+		delete waiting.variable;
+}
+
+template <class Unit>
+void PrecedenceParser<Unit>::next()
+{
+	int length;
+
+	while (cursor < size) {
+		uint point = codePoint(text, size, cursor, &length);
+		if (point != ' ' && point != '\t')
+			break;
+		cursor += length;
+	}
+
+	token.start = cursor;
+
+	if (cursor == size) {
+		token.kind = END_TOKEN;
+		token.length = 0;
+		return;
+	}
+
+	uint point = codePoint(text, size, cursor, &length);
+
+	if (isLetter(point)) {
+		while (cursor + length < size) {
+			int next;
+			uint following = codePoint(text, size, cursor + length, &next);
+			if (!isLetter(following) && !isDigit(following))
+				break;
+			length += next;
+		}
+
+		token.kind = IDENTIFIER_TOKEN;
+	} else if (point == '(')
+		token.kind = LBRACKET_TOKEN;
+	else if (point == ')')
+		token.kind = RBRACKET_TOKEN;
+	else if (point == ',')
+		token.kind = COMMA_TOKEN;
+	else if (point == SYMBOL_EQUALS.unicode())
+		token.kind = EQUALS_TOKEN;
+	else if (point == SYMBOL_NOT.unicode())
+		token.kind = NOT_TOKEN;
+	else if (point == SYMBOL_AND.unicode())
+		token.kind = AND_TOKEN;
+	else if (point == SYMBOL_OR.unicode())
+		token.kind = OR_TOKEN;
+	else if (point == SYMBOL_IMPLIES.unicode())
+		token.kind = IMPLIES_TOKEN;
+	else if (point == SYMBOL_IFF.unicode())
+		token.kind = IFF_TOKEN;
+	else if (point == SYMBOL_TRUTH.unicode())
+		token.kind = TRUTH_TOKEN;
+	else if (point == SYMBOL_FALSITY.unicode())
+		token.kind = FALSITY_TOKEN;
+	else if (point == SYMBOL_FORALL.unicode())
+		token.kind = FORALL_TOKEN;
+	else if (point == SYMBOL_THEREEXISTS.unicode())
+		token.kind = THEREEXISTS_TOKEN;
+	else
+		token.kind = UNKNOWN_TOKEN;
+
+	token.length = length;
+	cursor += length;
+}
+
+template <class Unit>
+bool PrecedenceParser<Unit>::fail()
+{
+	if (token.kind == UNKNOWN_TOKEN)
+		*message = QString("Unknown token: %1")
+		               .arg(spelling(text + token.start, token.length));
+	else if (token.kind == END_TOKEN)
+		*message = QString("Unexpected end of formula");
+	else
+		*message = QString("Unexpected %1")
+		               .arg(spelling(text + token.start, token.length));
+
+	*position = token.start;
+	return false;
+}
+
+template <class Unit>
+bool PrecedenceParser<Unit>::expect(TokenKind kind)
+{
+	return token.kind == kind || fail();
+}
+
+/* Builds the pending connectives binding at least as tight as power */
+template <class Unit>
+void PrecedenceParser<Unit>::reduce(int power)
+{
+	while (!pending.isEmpty() && bindingPower(pending.last().kind) >= power) {
+		TokenKind kind = pending.last().kind;
+		pending.removeLast();
+
+		LogicStatement *right = operands.last();
+		operands.removeLast();
+
+		if (kind == NOT_TOKEN) {
+			operands.append(new NotStatement(right));
+			continue;
+		}
+
+		LogicStatement *left = operands.last();
+		operands.removeLast();
+
+		switch (kind) {
+		case AND_TOKEN:
+			operands.append(new AndStatement(left, right));
+			break;
+		case OR_TOKEN:
+			operands.append(new OrStatement(left, right));
+			break;
+		case IMPLIES_TOKEN:
+			operands.append(new ImpliesStatement(left, right));
+			break;
+		default:
+			operands.append(new IffStatement(left, right));
+			break;
+		}
+	}
+}
+
+/* Variable, equality or predicate, starting at an identifier */
+template <class Unit>
+bool PrecedenceParser<Unit>::parseAtom()
+{
+	Variable *name =
+	    new Variable(internIdentifier(text + token.start, token.length));
+	next();
+
+	if (token.kind == EQUALS_TOKEN) {
+		next();
+		if (!expect(IDENTIFIER_TOKEN)) {
+			delete name;
+			return false;
+		}
+
+		operands.append(new EqualityStatement(
+		    name,
+		    new Variable(internIdentifier(text + token.start, token.length))));
+		next();
+		return true;
+	}
+
+	if (token.kind != LBRACKET_TOKEN) {
+		operands.append(name);
+		return true;
+	}
+
+	QVarLengthArray<Variable *, 8> parameters;
+
+	do {
+		next();
+		if (!expect(IDENTIFIER_TOKEN)) {
+			delete name;
+			for (Variable *parameter : parameters)
+				delete parameter;
+			return false;
+		}
+
+		parameters.append(
+		    new Variable(internIdentifier(text + token.start, token.length)));
+		next();
+	} while (token.kind == COMMA_TOKEN);
+
+	if (!expect(RBRACKET_TOKEN)) {
+		delete name;
+		for (Variable *parameter : parameters)
+			delete parameter;
+		return false;
+	}
+
+	next();
+
+	Parameters *list = nullptr;
+	for (int index = parameters.size() - 1; index >= 0; --index)
+		list = new Parameters(parameters.at(index), list);
+
+	operands.append(new PredicateSymbolStatement(name, list));
+	return true;
+}
+
+template <class Unit>
+LogicStatement *PrecedenceParser<Unit>::parse()
+{
+	next();
+
+	if (token.kind == END_TOKEN) {
+		*message = QString("Empty formula");
+		*position = 0;
+		return nullptr;
+	}
+
+	bool expectOperand = true;
+
+	for (;;) {
+		if (expectOperand) {
+			switch (token.kind) {
+			case NOT_TOKEN:
+			case LBRACKET_TOKEN:
+				pending.append(Pending{token.kind, nullptr});
+				next();
+				break;
+			case FORALL_TOKEN:
+			case THEREEXISTS_TOKEN: {
+				TokenKind kind = token.kind;
+
+				next();
+				if (!expect(IDENTIFIER_TOKEN))
+					return nullptr;
+
+				Variable *variable = new Variable(
+				    internIdentifier(text + token.start, token.length));
+				next();
+
+				/* The body is bracketed, the bracket closing it closes
+				 * the quantifier */
+				if (!expect(LBRACKET_TOKEN)) {
+					delete variable;
+					return nullptr;
+				}
+
+				pending.append(Pending{kind, variable});
+				next();
+				break;
+			}
+			case TRUTH_TOKEN:
+				operands.append(new Truth());
+				next();
+				expectOperand = false;
+				break;
+			case FALSITY_TOKEN:
+				operands.append(new Falsity());
+				next();
+				expectOperand = false;
+				break;
+			case IDENTIFIER_TOKEN:
+				if (!parseAtom())
+					return nullptr;
+				expectOperand = false;
+				break;
+			default:
+				fail();
+				return nullptr;
+			}
+
+			continue;
+		}
+
+		switch (token.kind) {
+		case AND_TOKEN:
+		case OR_TOKEN:
+		case IMPLIES_TOKEN:
+		case IFF_TOKEN:
+			/* Left associative */
+			reduce(bindingPower(token.kind));
+			pending.append(Pending{token.kind, nullptr});
+			next();
+			expectOperand = true;
+			break;
+		case RBRACKET_TOKEN: {
+			reduce(1);
+			if (pending.isEmpty()) {
+				fail();
+				return nullptr;
+			}
+
+			Pending opened = pending.last();
+			pending.removeLast();
+
+			if (opened.kind == FORALL_TOKEN)
+				operands.last() =
+				    new ForAllStatement(opened.variable, operands.last());
+			else if (opened.kind == THEREEXISTS_TOKEN)
+				operands.last() =
+				    new ThereExistsStatement(opened.variable, operands.last());
+
+			next();
+			break;
+		}
+		case END_TOKEN: {
+			reduce(1);
+			if (!pending.isEmpty()) {
+				fail();
+				return nullptr;
+			}
+
+			LogicStatement *result = operands.last();
+			operands.removeLast();
+			return result;
+		}
+		default:
+			fail();
+			return nullptr;
+		}
+	}
+}
+
+/* Checks what the grammar leaves to the AST */
+static LogicStatement *validated(LogicStatement *result, QString *message,
+                                 int *position)
+{
+	if (result != nullptr && result->isFirstOrderLogic() &&
+	    !result->validFirstOrderStatement()) {
+		*message = QString("Invalid first order statement");
+		*position = 0;
+		delete result;
+		return nullptr;
+	}
+
+	return result;
+}
+
+FormulaParser::FormulaParser() : position(-1)
+{
+}
+
+LogicStatement *FormulaParser::parse(const QString &expression)
+{
+	message.clear();
+	position = -1;
+
+	PrecedenceParser<QChar> parser(expression.constData(), expression.size(),
+	                               &message, &position);
+	return validated(parser.parse(), &message, &position);
+}
+
+LogicStatement *FormulaParser::parse(const char *expression, int length)
+{
+	message.clear();
+	position = -1;
+
+	PrecedenceParser<char> parser(expression, length, &message, &position);
+	return validated(parser.parse(), &message, &position);
+}
+
+const QString &FormulaParser::errorMessage() const
+{
+	return message;
+}
+
+int FormulaParser::errorPosition() const
+{
+	return position;
+}
@@ -0,0 +1,40 @@
+#ifndef FORMULAPARSER_HPP
+#define FORMULAPARSER_HPP
+
+#include <QString>
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* Hand written parser for the language of the bison grammar kept in
+ * benchmarks/parser.y, building the same ASTs. Connectives are parsed by
+ * precedence on explicit stacks, from the loosest IFF, IMPLIES, OR and AND,
+ * all left associative, to NOT, so nesting is not bounded by the native
+ * stack. The input is scanned in place and identifiers are interned without
+ * a temporary string. A parser is used by one thread at a time, any number
+ * of them may parse at once */
+class FormulaParser
+{
+	QString message;
+	int position;
+
+  public:
+	FormulaParser();
+
+	/* Returns a newly allocated AST for expression, or nullptr when it is
+	 * not well formed, errorMessage and errorPosition then telling why */
+	AST::LogicStatement *parse(const QString &expression);
+
+	/* Same for an expression in UTF-8, e.g. straight from a file */
+	AST::LogicStatement *parse(const char *expression, int length);
+
+	const QString &errorMessage() const;
+
+	/* Offset in code units of the expression of the token the error was
+	 * found at */
+	int errorPosition() const;
+};
+
+#endif // FORMULAPARSER_HPP
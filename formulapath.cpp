@@ -0,0 +1,255 @@
+#include "formulapath.hpp"
+#include "AST.hpp"
+#include "statementwalker.hpp"
+
+using namespace AST;
+
+FormulaPath::FormulaPath()
+{
+}
+
+int FormulaPath::length() const
+{
+	return steps.size();
+}
+
+bool FormulaPath::isRoot() const
+{
+	return steps.isEmpty();
+}
+
+int FormulaPath::at(int depth) const
+{
+	return steps.at(depth);
+}
+
+FormulaPath FormulaPath::child(int index) const
+{
+	FormulaPath path(*this);
+	path.steps.append(quint8(index));
+	return path;
+}
+
+FormulaPath FormulaPath::parent() const
+{
+	FormulaPath path(*this);
+	if (!path.steps.isEmpty())
+		path.steps.removeLast();
+	return path;
+}
+
+bool FormulaPath::operator==(const FormulaPath &other) const
+{
+	return steps == other.steps;
+}
+
+bool FormulaPath::operator!=(const FormulaPath &other) const
+{
+	return steps != other.steps;
+}
+
+/* Side of the formula graph node holding child index of the statement it
+ * was built from, -1 for the predicate symbol, which the graph keeps as the
+ * name of the node rather than as a child */
+static int graphSide(const Formula &node, int index)
+{
+	return node.getSymbol() == PREDICATE_SYMBOL ? index - 1 : index;
+}
+
+static Formula graphChild(const Formula &node, int index)
+{
+	switch (graphSide(node, index)) {
+	case 0:
+		return node.getLeft();
+	case 1:
+		return node.getRight();
+	default:
+		return Formula();
+	}
+}
+
+void FormulaPath::setChild(LogicStatement *statement, int index,
+                           LogicStatement *child)
+{
+	switch (statement->getSymbol()) {
+	case VARIABLE_SYMBOL:
+	case TRUTH_SYMBOL:
+	case FALSITY_SYMBOL:
+		break;
+	case NOT_SYMBOL:
+		static_cast<UnaryOpStatement *>(statement)->setStatement(child);
+		break;
+	case FORALL_SYMBOL: {
+		ForAllStatement *forAll = static_cast<ForAllStatement *>(statement);
+		if (index == 0)
+			forAll->setIdentifier(static_cast<Variable *>(child));
+		else
+			forAll->setStatement(child);
+		break;
+	}
+	case THEREEXISTS_SYMBOL: {
+		ThereExistsStatement *thereExists =
+		    static_cast<ThereExistsStatement *>(statement);
+		if (index == 0)
+			thereExists->setIdentifier(static_cast<Variable *>(child));
+		else
+			thereExists->setStatement(child);
+		break;
+	}
+	case PARAMETERS_SYMBOL: {
+		Parameters *parameters = static_cast<Parameters *>(statement);
+		if (index == 0)
+			parameters->setParameter(static_cast<Variable *>(child));
+		else
+			parameters->setRemainingParameters(
+			    static_cast<Parameters *>(child));
+		break;
+	}
+	case PREDICATE_SYMBOL: {
+		PredicateSymbolStatement *predicate =
+		    static_cast<PredicateSymbolStatement *>(statement);
+		if (index == 0)
+			predicate->setPredicateSymbol(static_cast<Variable *>(child));
+		else
+			predicate->setParameters(static_cast<Parameters *>(child));
+		break;
+	}
+	case EQUALS_SYMBOL: {
+		EqualityStatement *equality =
+		    static_cast<EqualityStatement *>(statement);
+		if (index == 0)
+			equality->setLeftVariable(static_cast<Variable *>(child));
+		else
+			equality->setRightVariable(static_cast<Variable *>(child));
+		break;
+	}
+	default: {
+		BinaryOpStatement *binary = static_cast<BinaryOpStatement *>(statement);
+		if (index == 0)
+			binary->setLeftStatement(child);
+		else
+			binary->setRightStatement(child);
+		break;
+	}
+	}
+}
+
+LogicStatement *FormulaPath::get(LogicStatement *root) const
+{
+	LogicStatement *current = root;
+
+	for (int i = 0; i < steps.size() && current; ++i)
+		current = current->getChild(steps.at(i));
+
+	return current;
+}
+
+Formula FormulaPath::get(const Formula &root) const
+{
+	Formula current = root;
+
+	for (int i = 0; i < steps.size() && !current.isNull(); ++i)
+		current = graphChild(current, steps.at(i));
+
+	return current;
+}
+
+LogicStatement *FormulaPath::replace(LogicStatement *root,
+                                     LogicStatement *replacement) const
+{
+	if (steps.isEmpty())
+		return replacement;
+
+	LogicStatement *owner = root;
+
+	/* Everything above the replaced subformula summarises it */
+	for (int i = 0; i < steps.size() - 1 && owner; ++i) {
+		owner->invalidateSummary();
+		owner = owner->getChild(steps.at(i));
+	}
+
+	if (owner)
+		setChild(owner, steps.last(), replacement);
+
+	return root;
+}
+
+Formula FormulaPath::replaced(const Formula &root,
+                              const Formula &replacement) const
+{
+	FormulaDag *dag = FormulaDag::globalDag();
+	QVector<Formula> spine;
+	Formula current = root;
+
+	for (int index : steps) {
+		spine.append(current);
+		current = graphChild(current, index);
+	}
+
+	/* Nothing is at the path, e.g. it leads to a predicate symbol */
+	if (current.isNull())
+		return root;
+
+	Formula result = replacement;
+
+	for (int i = steps.size() - 1; i >= 0; --i) {
+		const Formula &node = spine.at(i);
+
+		if (graphSide(node, steps.at(i)) == 0)
+			result = dag->make(node.getSymbol(), node.getId(), result,
+			                   node.getRight());
+		else
+			result = dag->make(node.getSymbol(), node.getId(), node.getLeft(),
+			                   result);
+	}
+
+	return result;
+}
+
+QHash<LogicStatement *, int> FormulaPath::preorder(LogicStatement *root)
+{
+	QHash<LogicStatement *, int> numbers;
+
+	StatementWalker::walk(root, [&numbers](LogicStatement *node, int stage) {
+		if (stage == 0)
+			numbers.insert(node, numbers.size());
+
+		return StatementWalker::CONTINUE;
+	});
+
+	return numbers;
+}
+
+FormulaPath FormulaPath::ofPreorder(LogicStatement *root, int number)
+{
+	FormulaPath path;
+	int visited = 0;
+
+	/* path follows the walk: a step is taken before a child is walked and
+	 * taken back once it has been */
+	StatementWalker::walk(root, [&path, &visited,
+	                             number](LogicStatement *node, int stage) {
+		if (stage == 0 && visited++ == number)
+			return StatementWalker::STOP;
+
+		if (stage > 0)
+			path.steps.removeLast();
+
+		if (node->getChild(stage) != nullptr)
+			path.steps.append(quint8(stage));
+
+		return StatementWalker::CONTINUE;
+	});
+
+	return visited > number ? path : FormulaPath();
+}
+
+uint qHash(const FormulaPath &path, uint seed)
+{
+	uint hash = seed ^ uint(path.length());
+
+	for (int i = 0; i < path.length(); ++i)
+		hash = hash * 31 + uint(path.at(i));
+
+	return hash;
+}
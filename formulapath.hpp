@@ -0,0 +1,70 @@
+#ifndef FORMULAPATH_HPP
+#define FORMULAPATH_HPP
+
+#include <QHash>
+#include <QVector>
+#include "formuladag.hpp"
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* Address of a subformula as the child indices taken from the root, with
+ * children numbered as by LogicStatement::getChild. In the formula graph a
+ * predicate keeps its symbol as the name and its parameters as the left
+ * child, so step 1 of a predicate leads to the left child there and step 0
+ * to nothing. A path stays meaningful across clones and interned copies of
+ * a formula, and every operation on it costs O(length) */
+class FormulaPath
+{
+	QVector<quint8> steps;
+
+	/* Inverse of LogicStatement::getChild, child must be of the type the
+	 * position holds */
+	static void setChild(AST::LogicStatement *statement, int index,
+	                     AST::LogicStatement *child);
+
+  public:
+	FormulaPath();
+
+	int length() const;
+	bool isRoot() const;
+	int at(int depth) const;
+
+	FormulaPath child(int index) const;
+	FormulaPath parent() const;
+
+	bool operator==(const FormulaPath &other) const;
+	bool operator!=(const FormulaPath &other) const;
+
+	/* Subformula at the path, nullptr or a null handle when root has no
+	 * such position */
+	AST::LogicStatement *get(AST::LogicStatement *root) const;
+	Formula get(const Formula &root) const;
+
+	/* Puts replacement at the path in place and returns the root, which is
+	 * replacement itself for the root path. The subformula that was there is
+	 * neither read nor freed */
+	AST::LogicStatement *replace(AST::LogicStatement *root,
+	                             AST::LogicStatement *replacement) const;
+
+	/* Returns root with the subformula at the path replaced, root itself
+	 * when nothing is there. Only the nodes along the path are rebuilt,
+	 * everything else is shared with root */
+	Formula replaced(const Formula &root, const Formula &replacement) const;
+
+	/* Preorder number of every node of root, for turning pointers handed
+	 * out by root, e.g. by getStringMapping, into addresses without building
+	 * a path per node. One walk of root */
+	static QHash<AST::LogicStatement *, int>
+	preorder(AST::LogicStatement *root);
+
+	/* Path of the node numbered number by preorder, the root path when root
+	 * has fewer nodes. Walks root up to that node */
+	static FormulaPath ofPreorder(AST::LogicStatement *root, int number);
+};
+
+uint qHash(const FormulaPath &path, uint seed = 0);
+
+#endif // FORMULAPATH_HPP
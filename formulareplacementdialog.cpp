@@ -18,7 +18,7 @@ FormulaReplacementDialog::FormulaReplacementDialog(
 	QString s = QString("Choose a rule to apply\nCurrent subformula is: ")
 	                .append(subformula->print(ET::fullBracket));
 	ui->instructionLabel->setText(s);
-	QVector<LogicSet *> *sl = ET::eqEng->match(subformula);
+	QVector<LogicSet *> *sl = ET::eqEng()->match(subformula);
 	for (LogicSet *l : *sl) {
 		RulePushButton *w =
 		    new RulePushButton(l->print(ET::fullBracket), l, this);
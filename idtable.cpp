@@ -1,7 +1,25 @@
 #include "idtable.hpp"
+#include "arena.hpp"
+
+#include <new>
 
 using namespace AST;
 
+/* Pairs are placed in the current arena together with their table */
+static QPair<Variable *, LogicStatement *> *newPair(Variable *key,
+                                                    LogicStatement *value)
+{
+	void *memory =
+	    Arena::allocate(sizeof(QPair<Variable *, LogicStatement *>));
+	return new (memory) QPair<Variable *, LogicStatement *>(key, value);
+}
+
+static void deletePair(QPair<Variable *, LogicStatement *> *pair)
+{
+	pair->~QPair<Variable *, LogicStatement *>();
+	Arena::release(pair);
+}
+
 IDTable::IDTable()
 {
 	id_table = new QVector<QPair<Variable *, LogicStatement *> *>();
@@ -9,7 +27,19 @@ IDTable::IDTable()
 
 IDTable::~IDTable() {
 	for (QPair<Variable *, LogicStatement *> *keyValuePair : *id_table)
-		delete keyValuePair;
+		deletePair(keyValuePair);
+
+	delete id_table;
+}
+
+void *IDTable::operator new(size_t size)
+{
+	return Arena::allocate(size);
+}
+
+void IDTable::operator delete(void *memory)
+{
+	Arena::release(memory);
 }
 
 bool IDTable::add(Variable *key, LogicStatement *value)
@@ -19,7 +49,7 @@ bool IDTable::add(Variable *key, LogicStatement *value)
 			return value->equals(keyValuePair->second);
 	}
 
-	id_table->push_back(new QPair<Variable *, LogicStatement *>(key, value));
+	id_table->push_back(newPair(key, value));
 	return true;
 }
 
@@ -37,13 +67,28 @@ LogicStatement *IDTable::valueOf(Variable *key)
 	return nullptr;
 }
 
+bool IDTable::add(const Formula &key, const Formula &value)
+{
+	if (handleTable.contains(key))
+		return handleTable.value(key) == value;
+
+	handleTable.insert(key, value);
+	return true;
+}
+
+Formula IDTable::valueOf(const Formula &key)
+{
+	return handleTable.value(key);
+}
+
 void IDTable::clear()
 {
 	if (!id_table->isEmpty())
 		for (QPair<Variable *, LogicStatement *> *pairs : *id_table)
-			delete pairs;
+			deletePair(pairs);
 
 	id_table->clear();
+	handleTable.clear();
 }
 
 void IDTable::deleteValues()
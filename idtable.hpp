@@ -1,8 +1,10 @@
 #ifndef IDTABLE_HPP
 #define IDTABLE_HPP
 
+#include <QHash>
 #include <QPair>
 #include "AST.hpp"
+#include "formuladag.hpp"
 
 namespace AST
 {
@@ -15,12 +17,17 @@ class IDTable
 {
   private:
 	QVector<QPair<AST::Variable *, AST::LogicStatement *> *> *id_table;
+	QHash<Formula, Formula> handleTable;
 
   public:
 	IDTable();
 
 	~IDTable();
 
+	/* Placed in the current arena when there is one */
+	static void *operator new(size_t size);
+	static void operator delete(void *memory);
+
 	/* Adding a key value pair that maps identifiers for rules to the filtered
 	 * version of the logicstatement which user provided */
 	bool add(AST::Variable *key, AST::LogicStatement *value);
@@ -32,6 +39,11 @@ class IDTable
 	 * none found */
 	AST::LogicStatement *valueOf(AST::Variable *key);
 
+	/* Same mapping on interned formulas, values are shared rather than
+	 * owned so nothing needs freeing */
+	bool add(const Formula &key, const Formula &value);
+	Formula valueOf(const Formula &key);
+
 	/* Free up the space allocated by Pairs and empty the mapping table */
 	void clear();
 
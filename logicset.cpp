@@ -1,4 +1,5 @@
 #include "logicset.hpp"
+#include "arena.hpp"
 #include "symbol.hpp"
 
 using namespace AST;
@@ -10,8 +11,13 @@ bool LogicSet::isEmpty()
 
 bool LogicSet::contains(Rule *item)
 {
-	for (Rule *set_elem : *set)
-		if (item->equals(set_elem))
+	return contains(Formula::fromStatement(item));
+}
+
+bool LogicSet::contains(const Formula &item)
+{
+	for (Rule *rule : *set)
+		if (Formula::fromStatement(rule) == item)
 			return true;
 
 	return false;
@@ -27,6 +33,17 @@ bool LogicSet::add(Rule *item)
 	return false;
 }
 
+QVector<Formula> LogicSet::handles()
+{
+	QVector<Formula> interned;
+
+	interned.reserve(set->size());
+	for (Rule *rule : *set)
+		interned.append(Formula::fromStatement(rule));
+
+	return interned;
+}
+
 LogicSet::LogicSet()
 {
 	set = new QVector<Rule *>();
@@ -37,6 +54,16 @@ LogicSet::~LogicSet()
 	delete set;
 }
 
+void *LogicSet::operator new(size_t size)
+{
+	return Arena::allocate(size);
+}
+
+void LogicSet::operator delete(void *memory)
+{
+	Arena::release(memory);
+}
+
 QVector<Rule *> *LogicSet::getSet()
 {
 	return set;
@@ -46,11 +73,11 @@ LogicSet *LogicSet::diff(Rule *item)
 {
 
 	auto remaining_set = new LogicSet();
+	Formula handle = Formula::fromStatement(item);
 
-	if (!isEmpty())
-		for (Rule *statement : *set)
-			if (!statement->equals(item))
-				remaining_set->add(statement);
+	for (Rule *rule : *set)
+		if (Formula::fromStatement(rule) != handle)
+			remaining_set->set->push_back(rule);
 
 	return remaining_set;
 }
@@ -59,18 +86,11 @@ LogicSet *LogicSet::diff(LogicSet *other)
 {
 
 	auto difference = new LogicSet();
-	QVector<LogicStatement *> *currentSet = getSet();
-
-	if (!currentSet->isEmpty()) {
-		if (other->isEmpty()) {
-			for (Rule *statement : *currentSet)
-				difference->add(statement);
-		} else {
-			for (Rule *statement : *currentSet)
-				if (!other->contains(statement))
-					difference->add(statement);
-		}
-	}
+	QVector<Formula> otherHandles = other->handles();
+
+	for (Rule *rule : *set)
+		if (!otherHandles.contains(Formula::fromStatement(rule)))
+			difference->set->push_back(rule);
 
 	return difference;
 }
@@ -99,8 +119,10 @@ bool LogicSet::equals(LogicSet *other)
 	if (set->size() != other->getSet()->size())
 		return false;
 
-	for (Rule *statement : *set)
-		if (!other->contains(statement))
+	QVector<Formula> otherHandles = other->handles();
+
+	for (Rule *rule : *set)
+		if (!otherHandles.contains(Formula::fromStatement(rule)))
 			return false;
 
 	return true;
@@ -115,8 +137,10 @@ bool LogicSet::contains(LogicSet *other)
 	if (set->size() < otherSet->size())
 		return false;
 
+	QVector<Formula> ownHandles = handles();
+
 	for (Rule *otherRule : *otherSet)
-		if (!this->contains(otherRule))
+		if (!ownHandles.contains(Formula::fromStatement(otherRule)))
 			return false;
 
 	return true;
@@ -140,13 +164,13 @@ QString LogicSet::getComment()
 
 bool LogicSet::remove(Rule *ruleRemove)
 {
-	for (int i = 0; i < set->size(); i++)
-		if (set->at(i)->equals(ruleRemove)) {
-			set->remove(i);
-			return true;
-		}
+	int i = handles().indexOf(Formula::fromStatement(ruleRemove));
 
-	return false;
+	if (i < 0)
+		return false;
+
+	set->remove(i);
+	return true;
 }
 
 bool LogicSet::addFront(Rule *rule)
@@ -3,6 +3,7 @@
 
 #include <QVector>
 #include "AST.hpp"
+#include "formuladag.hpp"
 
 namespace AST
 {
@@ -18,16 +19,27 @@ class LogicSet
 	QVector<Rule *> *set;
 	QString comment;
 
+	/* Interned form of every rule, in the order of set. Derived whenever
+	 * needed rather than kept, rules may be changed after being added */
+	QVector<Formula> handles();
+
   public:
 	LogicSet();
 	~LogicSet();
 
+	/* Placed in the current arena when there is one */
+	static void *operator new(size_t size);
+	static void operator delete(void *memory);
+
 	/* Calls Delete on each item in the LogicSet */
 	void deepDeleteContent();
 	bool isEmpty();
 
 	bool contains(Rule *);
 
+	/* Returns true iff a rule structurally equal to the formula exists */
+	bool contains(const Formula &);
+
 	/* Set Implementation of add() */
 	bool add(Rule *);
 
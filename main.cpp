@@ -1,18 +1,26 @@
 #include "main.hpp"
+#include "bitslicedevaluator.hpp"
 #include "mainwindow.hpp"
 
 #include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QLibraryInfo>
 #include <QLocale>
+#include <QTimer>
 #include <QTranslator>
 
 #define APP_VERSION "Beta 1"
 
 bool ET::fullBracket;
-EquivalenceEngine *ET::eqEng;
+QFuture<EquivalenceEngine *> ET::eqEngReady;
 
 int main(int argc, char *argv[])
 {
+	QElapsedTimer startup;
+	startup.start();
+
 	QApplication a(argc, argv);
 
 	a.setApplicationName("Equivalence Tutor");
@@ -26,5 +34,32 @@ int main(int argc, char *argv[])
 	MainWindow w;
 	w.show();
 
+	if (qEnvironmentVariableIsSet("ET_STARTUP_TIMING")) {
+		/* The first pass of the event loop paints the window */
+		QTimer::singleShot(0, [&startup]() {
+			qDebug() << "Main window shown after" << startup.elapsed()
+			         << "ms";
+		});
+
+		/* The window used to be built only once this had happened */
+		auto rulesLoaded = new QFutureWatcher<EquivalenceEngine *>(&a);
+		auto report = [&startup]() {
+			qDebug() << "Rule base loaded after" << startup.elapsed() << "ms";
+		};
+
+		QObject::connect(rulesLoaded, &QFutureWatcherBase::finished, report);
+		rulesLoaded->setFuture(ET::eqEngReady);
+	}
+
+	/* Tells how often the random rows settle a check before the truth table,
+	 * the diagrams or the solver are needed */
+	if (qEnvironmentVariableIsSet("ET_SIMULATION_STATISTICS"))
+		QObject::connect(&a, &QCoreApplication::aboutToQuit, []() {
+			qDebug() << "Random simulation refuted"
+			         << BitSlicedEvaluator::refutations() << "of"
+			         << BitSlicedEvaluator::simulations()
+			         << "equivalence checks";
+		});
+
 	return a.exec();
 }
@@ -3,10 +3,20 @@
 
 #include "equivalenceengine.hpp"
 
+#include <QFuture>
+
 namespace ET
 {
 extern bool fullBracket;
-extern EquivalenceEngine *eqEng;
+
+/* Rule base, loaded in the background while the main window comes up */
+extern QFuture<EquivalenceEngine *> eqEngReady;
+
+/* Waits for the rule base when it is still loading */
+inline EquivalenceEngine *eqEng()
+{
+	return eqEngReady.result();
+}
 }
 
 #endif // MAIN_HPP
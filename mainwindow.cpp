@@ -8,13 +8,16 @@
 #include <QDebug>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QtConcurrentRun>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow)
 {
-	ui->setupUi(this);
+	/* Only rule matching needs the rules, the window comes up meanwhile */
+	ET::eqEngReady =
+	    QtConcurrent::run([]() { return new EquivalenceEngine; });
 
-	ET::eqEng = new EquivalenceEngine;
+	ui->setupUi(this);
 
 	// File menu items
 	connect(ui->actionNewSolution, SIGNAL(triggered()), this,
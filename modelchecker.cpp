@@ -0,0 +1,433 @@
+#include "modelchecker.hpp"
+
+#include <QStringList>
+#include <QThreadPool>
+
+using namespace AST;
+
+#define DEFAULT_MAXIMUM_DOMAIN_SIZE 3
+#define DEFAULT_TIME_BUDGET 2000
+#define INTERPRETATION_LIMIT (quint64(1) << 62)
+#define PARALLEL_INTERPRETATION_THRESHOLD (1 << 12)
+#define CHUNKS_PER_THREAD 8
+#define TIMER_CHECK_INTERVAL 256
+
+QString FiniteModel::print()
+{
+	QStringList lines;
+
+	lines.append(QString("Domain {0, ..., %1}").arg(domainSize - 1));
+
+	for (const QString &name : constants.keys())
+		lines.append(QString("%1 = %2").arg(name).arg(constants.value(name)));
+
+	for (const QString &name : propositions.keys())
+		lines.append(QString("%1 = %2").arg(name).arg(
+		    propositions.value(name) ? "true" : "false"));
+
+	QHash<QString, int> arities;
+
+	for (const QPair<QString, int> &predicate : predicates.keys())
+		++arities[predicate.first];
+
+	for (const QPair<QString, int> &predicate : predicates.keys()) {
+		const QVector<bool> &table = predicates[predicate];
+		QStringList tuples;
+		int arity = predicate.second;
+		QString name = predicate.first;
+
+		/* Predicates sharing a name are told apart by their arity */
+		if (arities.value(name) > 1)
+			name += QString("/%1").arg(arity);
+
+		for (int index = 0; index < table.size(); ++index) {
+			if (!table.at(index))
+				continue;
+
+			QStringList tuple;
+			for (int i = 0, rest = index; i < arity; ++i, rest /= domainSize)
+				tuple.append(QString::number(rest % domainSize));
+
+			tuples.append(QString("(%1)").arg(tuple.join(", ")));
+		}
+
+		lines.append(QString("%1 holds for %2").arg(name).arg(
+		    tuples.isEmpty() ? QString("nothing") : tuples.join(", ")));
+	}
+
+	return lines.join("\n");
+}
+
+ModelChecker::ModelChecker(LogicStatement *left, LogicStatement *right)
+{
+	termSlotCount = 0;
+	maximumDomainSize = DEFAULT_MAXIMUM_DOMAIN_SIZE;
+	timeBudget = DEFAULT_TIME_BUDGET;
+
+	leftRoot = compile(left);
+	rightRoot = compile(right);
+}
+
+void ModelChecker::setMaximumDomainSize(int size)
+{
+	maximumDomainSize = size;
+}
+
+void ModelChecker::setTimeBudget(int milliseconds)
+{
+	timeBudget = milliseconds;
+}
+
+int ModelChecker::addNode(Symbol opcode, int left, int right, int slot)
+{
+	program.append(Node{opcode, left, right, slot});
+	return program.size() - 1;
+}
+
+int ModelChecker::termSlot(Variable *variable)
+{
+	quint32 id = variable->getId();
+
+	/* Innermost quantifier binding the name wins */
+	for (int i = scope.size() - 1; i >= 0; --i)
+		if (scope.at(i).first == id)
+			return scope.at(i).second;
+
+	/* Free variables are constants of the interpretation */
+	if (!constantSlot.contains(id)) {
+		constantSlot.insert(id, termSlotCount);
+		constantSlots.append(termSlotCount++);
+		constantNames.append(variable->getName());
+	}
+
+	return constantSlot.value(id);
+}
+
+int ModelChecker::compile(LogicStatement *statement)
+{
+	switch (statement->getSymbol()) {
+	case VARIABLE_SYMBOL: {
+		Variable *variable = static_cast<Variable *>(statement);
+		quint32 id = variable->getId();
+
+		if (!propositionSlot.contains(id)) {
+			propositionSlot.insert(id, propositionNames.size());
+			propositionNames.append(variable->getName());
+		}
+
+		return addNode(VARIABLE_SYMBOL, 0, 0, propositionSlot.value(id));
+	}
+	case TRUTH_SYMBOL:
+	case FALSITY_SYMBOL:
+		return addNode(statement->getSymbol(), 0, 0, 0);
+	case NOT_SYMBOL:
+		return addNode(
+		    NOT_SYMBOL,
+		    compile(dynamic_cast<UnaryOpStatement *>(statement)->getStatement()),
+		    0, 0);
+	case FORALL_SYMBOL:
+	case THEREEXISTS_SYMBOL: {
+		Variable *identifier;
+		LogicStatement *body;
+
+		if (statement->getSymbol() == FORALL_SYMBOL) {
+			ForAllStatement *forAll = dynamic_cast<ForAllStatement *>(statement);
+			identifier = forAll->getQuantifier();
+			body = forAll->getStatement();
+		} else {
+			ThereExistsStatement *thereExists =
+			    dynamic_cast<ThereExistsStatement *>(statement);
+			identifier = thereExists->getQuantifier();
+			body = thereExists->getStatement();
+		}
+
+		/* Every quantifier gets a slot of its own, so shadowing needs no
+		 * saving and restoring at evaluation time */
+		int slot = termSlotCount++;
+
+		scope.append(qMakePair(identifier->getId(), slot));
+		int child = compile(body);
+		scope.removeLast();
+
+		return addNode(statement->getSymbol(), child, 0, slot);
+	}
+	case EQUALS_SYMBOL: {
+		EqualityStatement *equality = dynamic_cast<EqualityStatement *>(statement);
+		return addNode(EQUALS_SYMBOL, termSlot(equality->getLeftVariable()),
+		               termSlot(equality->getRightVariable()), 0);
+	}
+	case PREDICATE_SYMBOL: {
+		PredicateSymbolStatement *predicate =
+		    dynamic_cast<PredicateSymbolStatement *>(statement);
+		int first = arguments.size();
+
+		for (Parameters *parameters = predicate->getParameters();
+		     parameters != nullptr;
+		     parameters = parameters->getRemainingParameters())
+			arguments.append(termSlot(parameters->getParameter()));
+
+		int arity = arguments.size() - first;
+
+		/* Predicates are told apart by name and arity */
+		QString key = QString("%1/%2")
+		                  .arg(predicate->getPredicateSymbolName())
+		                  .arg(arity);
+
+		if (!predicateSlot.contains(key)) {
+			predicateSlot.insert(key, predicateNames.size());
+			predicateNames.append(predicate->getPredicateSymbolName());
+			predicateArity.append(arity);
+		}
+
+		return addNode(PREDICATE_SYMBOL, first, arity, predicateSlot.value(key));
+	}
+	default: {
+		BinaryOpStatement *binary = dynamic_cast<BinaryOpStatement *>(statement);
+		int left = compile(binary->getLeftStatement());
+		int right = compile(binary->getRightStatement());
+		return addNode(statement->getSymbol(), left, right, 0);
+	}
+	}
+}
+
+void ModelChecker::layout(Search *search) const
+{
+	int size = search->domainSize;
+
+	search->radix.clear();
+	search->tableOffset.clear();
+
+	for (int i = 0; i < constantNames.size(); ++i)
+		search->radix.append(size);
+
+	for (int i = 0; i < propositionNames.size(); ++i)
+		search->radix.append(2);
+
+	for (int arity : predicateArity) {
+		int entries = 1;
+		for (int i = 0; i < arity; ++i)
+			entries *= size;
+
+		search->tableOffset.append(search->radix.size());
+		for (int i = 0; i < entries; ++i)
+			search->radix.append(2);
+	}
+
+	/* Saturate rather than overflow, such a search can only time out */
+	search->interpretationCount = 1;
+	search->complete = true;
+
+	for (int radix : search->radix) {
+		if (search->interpretationCount > INTERPRETATION_LIMIT / radix) {
+			search->interpretationCount = INTERPRETATION_LIMIT;
+			search->complete = false;
+			break;
+		}
+
+		search->interpretationCount *= radix;
+	}
+}
+
+void ModelChecker::decode(quint64 index, const QVector<int> &radix,
+                          QVector<int> &digits) const
+{
+	for (int i = 0; i < radix.size(); ++i) {
+		digits[i] = index % radix.at(i);
+		index /= radix.at(i);
+	}
+}
+
+void ModelChecker::increment(const QVector<int> &radix,
+                             QVector<int> &digits) const
+{
+	for (int i = 0; i < radix.size(); ++i) {
+		if (++digits[i] < radix.at(i))
+			return;
+
+		digits[i] = 0;
+	}
+}
+
+bool ModelChecker::evaluate(int node, const Search *search,
+                            const QVector<int> &digits,
+                            QVector<int> &environment) const
+{
+	const Node &op = program.at(node);
+
+	switch (op.opcode) {
+	case VARIABLE_SYMBOL:
+		return digits.at(constantNames.size() + op.slot);
+	case TRUTH_SYMBOL:
+		return true;
+	case FALSITY_SYMBOL:
+		return false;
+	case NOT_SYMBOL:
+		return !evaluate(op.left, search, digits, environment);
+	case AND_SYMBOL:
+		return evaluate(op.left, search, digits, environment) &&
+		       evaluate(op.right, search, digits, environment);
+	case OR_SYMBOL:
+		return evaluate(op.left, search, digits, environment) ||
+		       evaluate(op.right, search, digits, environment);
+	case IMPLIES_SYMBOL:
+		return !evaluate(op.left, search, digits, environment) ||
+		       evaluate(op.right, search, digits, environment);
+	case IFF_SYMBOL:
+		return evaluate(op.left, search, digits, environment) ==
+		       evaluate(op.right, search, digits, environment);
+	case FORALL_SYMBOL:
+		for (int value = 0; value < search->domainSize; ++value) {
+			environment[op.slot] = value;
+			if (!evaluate(op.left, search, digits, environment))
+				return false;
+		}
+		return true;
+	case THEREEXISTS_SYMBOL:
+		for (int value = 0; value < search->domainSize; ++value) {
+			environment[op.slot] = value;
+			if (evaluate(op.left, search, digits, environment))
+				return true;
+		}
+		return false;
+	case EQUALS_SYMBOL:
+		return environment.at(op.left) == environment.at(op.right);
+	case PREDICATE_SYMBOL: {
+		int entry = 0;
+
+		for (int i = op.right - 1; i >= 0; --i)
+			entry = entry * search->domainSize +
+			        environment.at(arguments.at(op.left + i));
+
+		return digits.at(search->tableOffset.at(op.slot) + entry);
+	}
+	default:
+		return false;
+	}
+}
+
+bool ModelChecker::timedOut() const
+{
+	return timer.elapsed() > timeBudget;
+}
+
+void ModelChecker::Search::work()
+{
+	checker->searchChunks(this);
+}
+
+void ModelChecker::searchChunks(Search *search) const
+{
+	QVector<int> digits(search->radix.size());
+	QVector<int> environment(termSlotCount);
+
+	for (;;) {
+		quint64 chunk = quint64(search->nextChunk.fetchAndAddRelaxed(1));
+
+		if (chunk >= search->chunkCount || search->found.load())
+			return;
+
+		quint64 first = search->interpretationCount / search->chunkCount * chunk;
+		quint64 last = chunk + 1 == search->chunkCount
+		                   ? search->interpretationCount
+		                   : first + search->interpretationCount /
+		                                 search->chunkCount;
+
+		decode(first, search->radix, digits);
+
+		for (quint64 index = first; index < last; ++index) {
+			if ((index - first) % TIMER_CHECK_INTERVAL == 0 &&
+			    (search->found.load() || timedOut()))
+				return;
+
+			for (int i = 0; i < constantSlots.size(); ++i)
+				environment[constantSlots.at(i)] = digits.at(i);
+
+			if (evaluate(leftRoot, search, digits, environment) !=
+			    evaluate(rightRoot, search, digits, environment)) {
+				/* Only the first worker to find a model reports it */
+				if (search->found.testAndSetOrdered(0, 1))
+					search->distinguishing = index;
+				return;
+			}
+
+			increment(search->radix, digits);
+		}
+	}
+}
+
+void ModelChecker::readModel(const Search *search, quint64 index)
+{
+	QVector<int> digits(search->radix.size());
+	int size = search->domainSize;
+
+	decode(index, search->radix, digits);
+
+	model.domainSize = size;
+	model.constants.clear();
+	model.propositions.clear();
+	model.predicates.clear();
+
+	for (int i = 0; i < constantNames.size(); ++i)
+		model.constants.insert(constantNames.at(i), digits.at(i));
+
+	for (int i = 0; i < propositionNames.size(); ++i)
+		model.propositions.insert(propositionNames.at(i),
+		                          digits.at(constantNames.size() + i));
+
+	for (int p = 0; p < predicateNames.size(); ++p) {
+		int entries = 1;
+		for (int i = 0; i < predicateArity.at(p); ++i)
+			entries *= size;
+
+		QVector<bool> table(entries);
+		for (int i = 0; i < entries; ++i)
+			table[i] = digits.at(search->tableOffset.at(p) + i);
+
+		model.predicates.insert(
+		    qMakePair(predicateNames.at(p), predicateArity.at(p)), table);
+	}
+}
+
+ModelChecker::Result ModelChecker::check()
+{
+	int threads = QThreadPool::globalInstance()->maxThreadCount();
+	bool complete = true;
+
+	timer.start();
+
+	/* Small domains first, they give the most readable models */
+	for (int size = 1; size <= maximumDomainSize; ++size) {
+		Search search;
+		search.checker = this;
+		search.domainSize = size;
+		layout(&search);
+		search.nextChunk.store(0);
+		search.found.store(0);
+
+		if (search.interpretationCount < PARALLEL_INTERPRETATION_THRESHOLD ||
+		    threads < 2) {
+			search.chunkCount = 1;
+			searchChunks(&search);
+		} else {
+			search.chunkCount = quint64(threads) * CHUNKS_PER_THREAD;
+			search.run(threads - 1);
+		}
+
+		if (search.found.load()) {
+			readModel(&search, search.distinguishing);
+			return DISTINGUISHED;
+		}
+
+		if (timedOut())
+			return TIMED_OUT;
+
+		complete = complete && search.complete;
+	}
+
+	return complete ? EQUIVALENT_UP_TO_BOUND : TIMED_OUT;
+}
+
+FiniteModel ModelChecker::distinguishingModel()
+{
+	return model;
+}
@@ -0,0 +1,124 @@
+#ifndef MODELCHECKER_HPP
+#define MODELCHECKER_HPP
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "AST.hpp"
+#include "paralleljob.hpp"
+
+/* Interpretation over the domain {0, ..., domainSize - 1} */
+struct FiniteModel
+{
+	int domainSize;
+	/* Free variables used as terms */
+	QMap<QString, int> constants;
+	/* Variables used as propositions */
+	QMap<QString, bool> propositions;
+	/* Truth table of every predicate by name and arity, indexed by the
+	 * arguments read as a number in base domainSize with the first argument
+	 * least significant */
+	QMap<QPair<QString, int>, QVector<bool>> predicates;
+
+	QString print();
+};
+
+/* Searches finite interpretations of two first order formulas for one on
+ * which they disagree. Domains of size 1 to the maximum are tried in turn,
+ * the interpretations of each size are split into chunks that are checked
+ * concurrently on the global thread pool */
+class ModelChecker
+{
+	struct Node
+	{
+		Symbol opcode;
+		/* Child nodes, term slots of EQUALS_SYMBOL or the first argument
+		 * and arity of PREDICATE_SYMBOL */
+		int left;
+		int right;
+		/* Proposition, predicate or bound variable slot */
+		int slot;
+	};
+
+	/* Shared state of the search over one domain size */
+	struct Search : ParallelJob
+	{
+		const ModelChecker *checker;
+		int domainSize;
+		/* Digits of an interpretation are the constants, the propositions
+		 * and then the truth tables of the predicates */
+		QVector<int> radix;
+		QVector<int> tableOffset;
+		quint64 interpretationCount;
+		/* False when there are too many interpretations to count */
+		bool complete;
+		quint64 chunkCount;
+		QAtomicInt nextChunk;
+		QAtomicInt found;
+		/* Written once by the worker that raised found */
+		quint64 distinguishing;
+
+		void work();
+	};
+
+	QVector<Node> program;
+	QVector<int> arguments;
+	QHash<quint32, int> constantSlot;
+	QVector<int> constantSlots;
+	QHash<quint32, int> propositionSlot;
+	QHash<QString, int> predicateSlot;
+	QVector<QString> constantNames;
+	QVector<QString> propositionNames;
+	QVector<QString> predicateNames;
+	QVector<int> predicateArity;
+	QVector<QPair<quint32, int>> scope;
+	int termSlotCount;
+	int leftRoot;
+	int rightRoot;
+
+	int maximumDomainSize;
+	int timeBudget;
+	QElapsedTimer timer;
+	FiniteModel model;
+
+	int compile(AST::LogicStatement *statement);
+	int addNode(Symbol opcode, int left, int right, int slot);
+	int termSlot(AST::Variable *variable);
+
+	void layout(Search *search) const;
+	void decode(quint64 index, const QVector<int> &radix,
+	            QVector<int> &digits) const;
+	void increment(const QVector<int> &radix, QVector<int> &digits) const;
+
+	bool evaluate(int node, const Search *search, const QVector<int> &digits,
+	              QVector<int> &environment) const;
+
+	/* Claims chunks of the search until none are left, one interpretation
+	 * tells the formulas apart or the time budget runs out */
+	void searchChunks(Search *search) const;
+	bool timedOut() const;
+
+	void readModel(const Search *search, quint64 index);
+
+  public:
+	enum Result { EQUIVALENT_UP_TO_BOUND, DISTINGUISHED, TIMED_OUT };
+
+	ModelChecker(AST::LogicStatement *left, AST::LogicStatement *right);
+
+	/* Largest domain searched, 3 unless set */
+	void setMaximumDomainSize(int size);
+
+	/* Wall clock limit in milliseconds, 2000 unless set */
+	void setTimeBudget(int milliseconds);
+
+	Result check();
+
+	/* Interpretation found by the last check returning DISTINGUISHED */
+	FiniteModel distinguishingModel();
+};
+
+#endif // MODELCHECKER_HPP
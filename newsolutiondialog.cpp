@@ -1,16 +1,23 @@
 #include "newsolutiondialog.hpp"
 #include "ui_newsolutiondialog.h"
+#include "modelchecker.hpp"
+#include "parsecache.hpp"
 
 #include <QDebug>
 #include <QMessageBox>
-
-QString lexerErrorMessage, parserErrorMessage;
+#include <QPushButton>
+#include <QStringList>
+#include <QtConcurrentRun>
 
 NewSolutionDialog::NewSolutionDialog(QWidget *parent)
-    : QDialog(parent), ui(new Ui::NewSolutionDialog)
+    : QDialog(parent), ui(new Ui::NewSolutionDialog), pendingBegin(nullptr),
+      pendingEnd(nullptr)
 {
 	ui->setupUi(this);
 
+	connect(&provability, SIGNAL(finished()), this,
+	        SLOT(provabilityChecked()));
+
 	connect(ui->buttonBox, SIGNAL(clicked(QAbstractButton *)), this,
 	        SLOT(onClick(QAbstractButton *)));
 	connect(ui->inputPanel, SIGNAL(stringGenerated(QString)), this,
@@ -19,6 +26,10 @@ NewSolutionDialog::NewSolutionDialog(QWidget *parent)
 
 NewSolutionDialog::~NewSolutionDialog()
 {
+	/* The check reads the formulas and cannot be cancelled */
+	provability.waitForFinished();
+	delete pendingBegin;
+	delete pendingEnd;
 	delete ui;
 }
 
@@ -29,49 +40,46 @@ void NewSolutionDialog::onClick(QAbstractButton *btn)
 		// Clear the warning
 		ui->startFormulaLabel->setStyleSheet("");
 		ui->endFormulaLabel->setStyleSheet("");
-		lexerErrorMessage.clear();
-		parserErrorMessage.clear();
 
-		AST::LogicStatement *begin = nullptr;
-		AST::LogicStatement *end = nullptr;
+		ParseCache *cache = ParseCache::globalCache();
+		QString error;
+		int position;
 
 		bool success = true;
 
-		if ((begin = AST::parse(ui->startFormulaLineEdit->text())) == nullptr) {
+		Formula start = cache->parse(ui->startFormulaLineEdit->text(),
+		                             &error, &position);
+		if (start.isNull()) {
 			QMessageBox msg;
 			ui->startFormulaLabel->setStyleSheet("QLabel { color : red; }");
+			ui->startFormulaLineEdit->setCursorPosition(position);
 			msg.warning(this, "Parsing failure",
-			            QString("Failed to parse start formula\n%1\n%2")
-			                .arg(lexerErrorMessage)
-			                .arg(parserErrorMessage));
+			            QString("Failed to parse start formula\n%1")
+			                .arg(error));
 			success = false;
 		}
-		if ((end = AST::parse(ui->endFormulaLineEdit->text())) == nullptr) {
+		Formula finish = cache->parse(ui->endFormulaLineEdit->text(),
+		                              &error, &position);
+		if (finish.isNull()) {
 			QMessageBox msg;
 			ui->endFormulaLabel->setStyleSheet("QLabel { color : red; }");
+			ui->endFormulaLineEdit->setCursorPosition(position);
 			msg.warning(this, "Parsing failure",
-			            QString("Failed to parse end formula\n%1\n%2")
-			                .arg(lexerErrorMessage)
-			                .arg(parserErrorMessage));
-			success = false;
-		}
-		if (success && !begin->isEquivalent(end)) {
-			QMessageBox msg;
-			ui->startFormulaLabel->setStyleSheet("QLabel { color : red; }");
-			ui->endFormulaLabel->setStyleSheet("QLabel { color : red; }");
-			msg.warning(this, "Not provable",
-			            "Start formula is not equivalent to end formula");
+			            QString("Failed to parse end formula\n%1")
+			                .arg(error));
 			success = false;
 		}
-		if (!success) {
-			if (begin != nullptr)
-				delete begin;
-			if (end != nullptr)
-				delete end;
-		} else {
-			emit accepted(begin, end, ui->nameLineEdit->text());
-			close();
-		}
+		if (!success)
+			break;
+
+		pendingBegin = start.toStatement();
+		pendingEnd = finish.toStatement();
+
+		/* A first order check may search models for its whole time budget,
+		 * the dialog keeps responding meanwhile, see provabilityChecked */
+		ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+		provability.setFuture(
+		    QtConcurrent::run(isProvable, pendingBegin, pendingEnd));
 		break;
 	}
 	case QDialogButtonBox::Cancel:
@@ -85,6 +93,61 @@ void NewSolutionDialog::onClick(QAbstractButton *btn)
 	}
 }
 
+QPair<bool, QString> NewSolutionDialog::isProvable(AST::LogicStatement *begin,
+                                                   AST::LogicStatement *end)
+{
+	if (begin->isFirstOrderLogic() || end->isFirstOrderLogic()) {
+		ModelChecker checker(begin, end);
+
+		if (checker.check() != ModelChecker::DISTINGUISHED)
+			return qMakePair(true, QString());
+
+		return qMakePair(false, checker.distinguishingModel().print());
+	}
+
+	QMap<QString, bool> counterexample;
+
+	if (begin->isEquivalent(end, &counterexample))
+		return qMakePair(true, QString());
+
+	QStringList assignment;
+	for (const QString &name : counterexample.keys())
+		assignment.append(QString("%1 = %2").arg(name).arg(
+		    counterexample.value(name) ? "true" : "false"));
+
+	return qMakePair(false, assignment.join("\n"));
+}
+
+void NewSolutionDialog::provabilityChecked()
+{
+	QPair<bool, QString> provable = provability.result();
+	AST::LogicStatement *begin = pendingBegin;
+	AST::LogicStatement *end = pendingEnd;
+
+	pendingBegin = nullptr;
+	pendingEnd = nullptr;
+	ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+
+	if (provable.first) {
+		emit accepted(begin, end, ui->nameLineEdit->text());
+		close();
+		return;
+	}
+
+	QString message("Start formula is not equivalent to end formula");
+
+	if (!provable.second.isEmpty())
+		message += QString("\nThey differ on\n%1").arg(provable.second);
+
+	QMessageBox msg;
+	ui->startFormulaLabel->setStyleSheet("QLabel { color : red; }");
+	ui->endFormulaLabel->setStyleSheet("QLabel { color : red; }");
+	msg.warning(this, "Not provable", message);
+
+	delete begin;
+	delete end;
+}
+
 void NewSolutionDialog::insertString(QString str)
 {
 	QWidget *w = QWidget::focusWidget();
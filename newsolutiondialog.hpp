@@ -3,6 +3,8 @@
 
 #include <QDialog>
 #include <QAbstractButton>
+#include <QFutureWatcher>
+#include <QPair>
 
 #include "AST.hpp"
 
@@ -26,9 +28,21 @@ signals:
   private:
 	Ui::NewSolutionDialog *ui;
 
+	/* Formulas being checked off the GUI thread, owned until the check
+	 * ends */
+	AST::LogicStatement *pendingBegin;
+	AST::LogicStatement *pendingEnd;
+	QFutureWatcher<QPair<bool, QString>> provability;
+
+	/* Returns true unless a counterexample is found, which is then
+	 * described in the second member. Runs on the thread pool */
+	static QPair<bool, QString> isProvable(AST::LogicStatement *begin,
+	                                       AST::LogicStatement *end);
+
   private
 slots:
 	void onClick(QAbstractButton *btn);
+	void provabilityChecked();
 	void insertString(QString str);
 	void accept() override;
 };
@@ -0,0 +1,52 @@
+#include "paralleljob.hpp"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+/* Helper of a job on a pool thread, signals finished once the work is done */
+class ParallelJobTask : public QRunnable
+{
+	ParallelJob *job;
+	QSemaphore *finished;
+
+  public:
+	ParallelJobTask(ParallelJob *job, QSemaphore *finished)
+	    : job(job), finished(finished)
+	{
+	}
+
+	void run()
+	{
+		job->work();
+		finished->release();
+	}
+};
+
+ParallelJob::~ParallelJob()
+{
+}
+
+void ParallelJob::run(int helpers)
+{
+	QThreadPool *pool = QThreadPool::globalInstance();
+	QSemaphore finished;
+	int started = 0;
+
+	/* tryStart only succeeds on a thread that runs the task right away, so
+	 * the helpers counted here are sure to finish. The queue is never used,
+	 * a queued helper could wait behind work that waits for this job */
+	while (started < helpers) {
+		ParallelJobTask *task = new ParallelJobTask(this, &finished);
+
+		if (!pool->tryStart(task)) {
+			delete task;
+			break;
+		}
+
+		++started;
+	}
+
+	work();
+	finished.acquire(started);
+}
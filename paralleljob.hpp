@@ -0,0 +1,27 @@
+#ifndef PARALLELJOB_HPP
+#define PARALLELJOB_HPP
+
+/* Work split into chunks that the threads taking part claim from shared
+ * state until none are left. Subclasses hold that state and implement work,
+ * which every thread runs once */
+class ParallelJob
+{
+	friend class ParallelJobTask;
+
+  protected:
+	/* Claims and processes chunks until there are none left or the job can
+	 * stop early. Runs concurrently on every thread taking part */
+	virtual void work() = 0;
+
+  public:
+	virtual ~ParallelJob();
+
+	/* Runs work on the calling thread and on up to helpers threads of the
+	 * global pool, returning once all of them are done. Only threads that
+	 * are idle at the time of the call help, a busy pool or a caller that
+	 * is itself a pool thread leaves the calling thread to do the job alone
+	 * rather than waiting */
+	void run(int helpers);
+};
+
+#endif // PARALLELJOB_HPP
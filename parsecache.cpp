@@ -0,0 +1,96 @@
+#include "parsecache.hpp"
+#include "AST.hpp"
+#include "formulaparser.hpp"
+
+#include <QMutexLocker>
+
+/* Entries, each a handle on nodes shared with the rest of the application */
+#define MAX_CACHED_FORMULAS 1024
+
+/* The scanner only tells blanks apart from the tokens around them, so runs
+ * of them are folded into one space and the ends are trimmed */
+static inline QString normalise(const QString &expression)
+{
+	QString key;
+	bool blank = false;
+
+	key.reserve(expression.size());
+	for (QChar c : expression) {
+		if (c == QChar(' ') || c == QChar('\t')) {
+			blank = !key.isEmpty();
+			continue;
+		}
+		if (blank)
+			key += QChar(' ');
+		key += c;
+		blank = false;
+	}
+
+	return key;
+}
+
+ParseCache::ParseCache()
+    : formulas(MAX_CACHED_FORMULAS), hitCount(0), missCount(0)
+{
+}
+
+ParseCache *ParseCache::globalCache()
+{
+	static ParseCache cache;
+	return &cache;
+}
+
+Formula ParseCache::parse(const QString &expression, QString *errorMessage,
+                          int *errorPosition)
+{
+	QString key = normalise(expression);
+
+	{
+		QMutexLocker locker(&mutex);
+		Formula *formula = formulas.object(key);
+
+		if (formula != nullptr) {
+			++hitCount;
+			return *formula;
+		}
+		++missCount;
+	}
+
+	/* Parsed outside the lock, a text parsed twice at once is just stored
+	 * twice */
+	FormulaParser parser;
+	AST::LogicStatement *statement = parser.parse(expression);
+
+	if (statement == nullptr) {
+		if (errorMessage)
+			*errorMessage = parser.errorMessage();
+		if (errorPosition)
+			*errorPosition = parser.errorPosition();
+		return Formula();
+	}
+
+	Formula formula = Formula::fromStatement(statement);
+	delete statement;
+
+	QMutexLocker locker(&mutex);
+	formulas.insert(key, new Formula(formula));
+	return formula;
+}
+
+void ParseCache::clear()
+{
+	QMutexLocker locker(&mutex);
+	formulas.clear();
+}
+
+int ParseCache::hits()
+{
+	QMutexLocker locker(&mutex);
+	return hitCount;
+}
+
+int ParseCache::misses()
+{
+	QMutexLocker locker(&mutex);
+	return missCount;
+}
@@ -0,0 +1,40 @@
+#ifndef PARSECACHE_HPP
+#define PARSECACHE_HPP
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include "formuladag.hpp"
+
+/* Remembers the formulas of recently parsed texts, so parsing a text typed
+ * again is a lookup. Texts differing only in blanks share an entry, the
+ * least recently used entries are dropped once the cache is full. Texts
+ * that fail to parse are not kept, so errors always come from a fresh
+ * parse of the text as given */
+class ParseCache
+{
+	QCache<QString, Formula> formulas;
+	QMutex mutex;
+	int hitCount;
+	int missCount;
+
+	ParseCache();
+
+  public:
+	/* Shared cache for the whole application */
+	static ParseCache *globalCache();
+
+	/* Returns the formula of expression, or a null formula when it is not
+	 * well formed, errorMessage and errorPosition, when given, then
+	 * telling why */
+	Formula parse(const QString &expression, QString *errorMessage = nullptr,
+	              int *errorPosition = nullptr);
+
+	void clear();
+
+	/* Number of parses answered from the cache and by parsing */
+	int hits();
+	int misses();
+};
+
+#endif // PARSECACHE_HPP
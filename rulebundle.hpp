@@ -0,0 +1,44 @@
+#ifndef RULEBUNDLE_HPP
+#define RULEBUNDLE_HPP
+
+#include "symbol.hpp"
+
+/* Rules of equivalences.xml, compiled into tables by rulecompiler.py when
+ * the application is built. The XML stays the place where rules are
+ * written, the tables only spare parsing it at every start up */
+
+/* Node of a rule in prefix order, children follow their parent. Names and
+ * the side conditions of variables are indices in bundledStrings, -1 when
+ * absent */
+struct BundledNode
+{
+	Symbol symbol;
+	short name;
+	short occurFree;
+	short notOccurFree;
+	short notOccur;
+	short mayOccur;
+};
+
+struct BundledRule
+{
+	int firstNode;
+	bool leibniz;
+};
+
+/* Rules of a set are consecutive */
+struct BundledRuleSet
+{
+	short comment;
+	int firstRule;
+	int ruleCount;
+};
+
+/* UTF-8 */
+extern const char *const bundledStrings[];
+extern const BundledNode bundledNodes[];
+extern const BundledRule bundledRules[];
+extern const BundledRuleSet bundledRuleSets[];
+extern const int bundledRuleSetCount;
+
+#endif // RULEBUNDLE_HPP
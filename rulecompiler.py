@@ -0,0 +1,137 @@
+#! /usr/bin/env python3
+
+# Compiles equivalences.xml into the tables declared in rulebundle.hpp
+#
+# Usage: rulecompiler.py equivalences.xml rulebundle.cpp
+
+import sys
+import xml.etree.ElementTree as ElementTree
+
+SYMBOLS = {
+    "ID": "VARIABLE_SYMBOL",
+    "Truth": "TRUTH_SYMBOL",
+    "Falsity": "FALSITY_SYMBOL",
+    "Not": "NOT_SYMBOL",
+    "And": "AND_SYMBOL",
+    "Or": "OR_SYMBOL",
+    "Implies": "IMPLIES_SYMBOL",
+    "IFF": "IFF_SYMBOL",
+    "ForAll": "FORALL_SYMBOL",
+    "ThereExists": "THEREEXISTS_SYMBOL",
+    "Equals": "EQUALS_SYMBOL",
+}
+
+ARITY = {
+    "ID": 0,
+    "Truth": 0,
+    "Falsity": 0,
+    "Not": 1,
+}
+
+CONDITIONS = ["OCCUR_FREE", "NOT_OCCUR_FREE", "NOT_OCCUR", "MAY_OCCUR"]
+
+
+class Bundle:
+    def __init__(self):
+        self.strings = []
+        self.stringIndex = {}
+        self.nodes = []
+        self.rules = []
+        self.ruleSets = []
+
+    def string(self, text):
+        if text is None or text == "":
+            return -1
+        if text not in self.stringIndex:
+            self.stringIndex[text] = len(self.strings)
+            self.strings.append(text)
+        return self.stringIndex[text]
+
+    def addNode(self, element):
+        if element.tag not in SYMBOLS:
+            sys.exit("Unknown element <%s>" % element.tag)
+
+        children = list(element)
+        arity = ARITY.get(element.tag, 2)
+        if len(children) != arity:
+            sys.exit("<%s> takes %d operands, not %d" %
+                     (element.tag, arity, len(children)))
+
+        name = -1
+        if element.tag == "ID":
+            name = self.string(element.text)
+        conditions = [self.string(element.get(c)) for c in CONDITIONS]
+        self.nodes.append([SYMBOLS[element.tag], name] + conditions)
+
+        for child in children:
+            self.addNode(child)
+
+    def addRuleSet(self, element):
+        firstRule = len(self.rules)
+
+        for statement in element.findall("LogicStatement"):
+            formula = list(statement)
+            if len(formula) != 1:
+                sys.exit("<LogicStatement> holds one formula")
+            leibniz = statement.get("FORWARD", "") != ""
+            self.rules.append((len(self.nodes), leibniz))
+            self.addNode(formula[0])
+
+        self.ruleSets.append((self.string(element.get("COMMENT")), firstRule,
+                              len(self.rules) - firstRule))
+
+
+def literal(text):
+    escaped = ""
+    for byte in text.encode("utf-8"):
+        character = chr(byte)
+        if character in "\\\"":
+            escaped += "\\" + character
+        elif 32 <= byte < 127:
+            escaped += character
+        else:
+            escaped += "\\%03o" % byte
+    return "\"%s\"" % escaped
+
+
+def write(bundle, out):
+    out.write("/* Generated by rulecompiler.py, do not edit */\n\n")
+    out.write("#include \"rulebundle.hpp\"\n\n")
+
+    out.write("const char *const bundledStrings[] = {\n")
+    for text in bundle.strings + [""]:
+        out.write("\t%s,\n" % literal(text))
+    out.write("};\n\n")
+
+    out.write("const BundledNode bundledNodes[] = {\n")
+    for node in bundle.nodes:
+        out.write("\t{%s},\n" % ", ".join(str(field) for field in node))
+    out.write("};\n\n")
+
+    out.write("const BundledRule bundledRules[] = {\n")
+    for firstNode, leibniz in bundle.rules:
+        out.write("\t{%d, %s},\n" % (firstNode, "true" if leibniz else "false"))
+    out.write("};\n\n")
+
+    out.write("const BundledRuleSet bundledRuleSets[] = {\n")
+    for ruleSet in bundle.ruleSets:
+        out.write("\t{%d, %d, %d},\n" % ruleSet)
+    out.write("};\n\n")
+
+    out.write("const int bundledRuleSetCount = %d;\n" % len(bundle.ruleSets))
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("Usage: %s equivalences.xml rulebundle.cpp" % sys.argv[0])
+
+    bundle = Bundle()
+    for element in ElementTree.parse(sys.argv[1]).iter("EquivalentStatements"):
+        bundle.addRuleSet(element)
+
+    with open(sys.argv[2], "w") as out:
+        write(bundle, out)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,18 +1,35 @@
 #include "ruleengine.hpp"
+#include "bddmanager.hpp"
+#include "rulebundle.hpp"
+#include "rulekey.hpp"
 #include <QFile>
-#include <QMessageBox>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QDebug>
+#include <QtConcurrentRun>
+#include <QtEndian>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace AST;
 
-#define GENERIC_RULE_PATH QString(":/equivalences.xml")
 #define USER_DEFINED_RULE_PATH QString("userDefinedRules.xml")
+#define USER_DEFINED_RULE_JOURNAL_PATH QString("userDefinedRules.journal")
+/* Size, sequence number and checksum of a journal record */
+#define JOURNAL_HEADER_BYTES int(3 * sizeof(quint32))
+/* Records after which the snapshot is rewritten and the journal emptied */
+#define JOURNAL_COMPACTION_RECORDS 64
 #define NONE ("")
 #define INITIAL_CHARACTER ('A')
 #define FINAL_CHARACTER ('Z')
 
 RuleEngine::RuleEngine()
+    : journal(nullptr), journalWritable(false), journalRecords(0),
+      compacting(false), compactedRecords(0)
 {
 	userDefinedRules = new QVector<LogicSet *>();
 	allRules = new QVector<LogicSet *>();
@@ -20,6 +37,12 @@ RuleEngine::RuleEngine()
 
 RuleEngine::~RuleEngine()
 {
+	if (compacting) {
+		compaction.waitForFinished();
+		finishCompaction();
+	}
+
+	delete journal;
 	delete userDefinedRules;
 	delete allRules;
 }
@@ -36,45 +59,358 @@ bool RuleEngine::addRule(LogicStatement *formulaFrom, LogicStatement *formulaTo)
 	LogicSet *generalisedRule = generateRuleSet(formulaSet);
 	delete formulaSet;
 
-	for (LogicSet *existingRuleSet : *allRules)
-		if (existingRuleSet->contains(generalisedRule)) {
-			generalisedRule->deepDeleteContent();
-			delete generalisedRule;
-			return false;
-		}
+	if (ruleIndex.contains(RuleKey::of(*generalisedRule->getSet()))) {
+		generalisedRule->deepDeleteContent();
+		delete generalisedRule;
+		return false;
+	}
 
 	userDefinedRules->append(generalisedRule);
 	allRules->append(generalisedRule);
-	flushNewRuleToXml();
+	indexRuleSet(generalisedRule);
+	journalRuleSet(generalisedRule);
 	return true;
 }
 
-void RuleEngine::flushNewRuleToXml()
+bool RuleEngine::knowsRule(LogicStatement *formulaFrom,
+                           LogicStatement *formulaTo)
 {
-	QFile userFile(USER_DEFINED_RULE_PATH);
+	QVector<Rule *> rule{formulaFrom};
 
-	userFile.open(QIODevice::WriteOnly | QIODevice::Text);
+	if (!formulaFrom->equals(formulaTo))
+		rule.append(formulaTo);
 
-	QXmlStreamWriter xml(&userFile);
-	xml.setAutoFormatting(true);
+	return ruleIndex.contains(RuleKey::of(rule));
+}
 
-	xml.writeStartDocument();
-	xml.writeStartElement("PropositionalEquivalences");
+void RuleEngine::indexRuleSet(LogicSet *ruleSet)
+{
+	QVector<Rule *> *rules = ruleSet->getSet();
+
+	/* A rule is known once a set holds both of its sides, so every member
+	 * and every pair of members is a key */
+	for (int i = 0; i < rules->size(); ++i) {
+		ruleIndex.insert(RuleKey::of(QVector<Rule *>{rules->at(i)}),
+		                 ruleSet);
+		for (int j = i + 1; j < rules->size(); ++j)
+			ruleIndex.insert(
+			    RuleKey::of(QVector<Rule *>{rules->at(i), rules->at(j)}),
+			    ruleSet);
+	}
+}
 
-	for (LogicSet *ruleSet : *userDefinedRules) {
-		xml.writeStartElement("EquivalentStatements");
-		for (Rule *rule : *ruleSet->getSet()) {
-			xml.writeStartElement("LogicStatement");
-			rule->generateRule(&xml);
-			xml.writeEndElement();
+QVector<QVector<LogicSet *>> RuleEngine::classifyRuleSets()
+{
+	BddManager *manager = BddManager::globalManager();
+	QVector<QVector<LogicSet *>> classes;
+	QHash<BddEdge, int> classOf;
+
+	for (LogicSet *ruleSet : *allRules) {
+		if (ruleSet->isEmpty())
+			continue;
+
+		Rule *representative = ruleSet->getSet()->first();
+		BddEdge edge;
+
+		if (representative->isFirstOrderLogic() ||
+		    !manager->fromStatement(representative, &edge))
+			continue;
+
+		/* Keep the edge alive while the remaining sets are converted */
+		if (!classOf.contains(edge)) {
+			manager->reference(edge);
+			classOf.insert(edge, classes.size());
+			classes.append(QVector<LogicSet *>());
 		}
-		xml.writeEndElement();
+
+		classes[classOf.value(edge)].append(ruleSet);
+	}
+
+	for (BddEdge edge : classOf.keys())
+		manager->dereference(edge);
+
+	return classes;
+}
+
+void RuleEngine::groupRuleSets()
+{
+	QVector<QVector<LogicSet *>> classes = classifyRuleSets();
+	QHash<LogicSet *, int> classOf;
+	QVector<LogicSet *> grouped;
+
+	for (int i = 0; i < classes.size(); ++i)
+		for (LogicSet *ruleSet : classes.at(i))
+			classOf.insert(ruleSet, i);
+
+	/* A class takes the place of its first set, the others follow it in
+	 * their own order. Sets left unclassified stay where they were */
+	for (LogicSet *ruleSet : *allRules) {
+		int i = classOf.value(ruleSet, -1);
+
+		if (i < 0)
+			grouped.append(ruleSet);
+		else if (classes.at(i).first() == ruleSet)
+			grouped += classes.at(i);
 	}
 
+	*allRules = grouped;
+}
+
+static QByteArray serialiseRuleSet(LogicSet *ruleSet)
+{
+	QByteArray record;
+	QXmlStreamWriter xml(&record);
+	xml.setAutoFormatting(true);
+
+	xml.writeStartElement("EquivalentStatements");
+	for (Rule *rule : *ruleSet->getSet()) {
+		xml.writeStartElement("LogicStatement");
+		rule->generateRule(&xml);
+		xml.writeEndElement();
+	}
 	xml.writeEndElement();
-	xml.writeEndDocument();
 
-	userFile.close();
+	return record;
+}
+
+/* The high half covers the size and sequence fields, so the size can be
+ * trusted before the payload it delimits is read */
+static inline quint16 headerChecksum(const char *record)
+{
+	return qChecksum(record, 2 * sizeof(quint32));
+}
+
+/* Covers the size and sequence fields and the payload, so neither a torn
+ * header nor a torn payload passes */
+static inline quint32 recordChecksum(const char *record, int payloadSize)
+{
+	quint16 payload =
+	    qChecksum(record + JOURNAL_HEADER_BYTES, uint(payloadSize));
+
+	return quint32(headerChecksum(record)) << 16 | payload;
+}
+
+static QByteArray journalRecord(int sequence, const QByteArray &payload)
+{
+	QByteArray record(JOURNAL_HEADER_BYTES, '\0');
+	uchar *header = reinterpret_cast<uchar *>(record.data());
+
+	qToLittleEndian<quint32>(quint32(payload.size()), header);
+	qToLittleEndian<quint32>(quint32(sequence), header + sizeof(quint32));
+	record += payload;
+	qToLittleEndian<quint32>(
+	    recordChecksum(record.constData(), payload.size()),
+	    reinterpret_cast<uchar *>(record.data()) + 2 * sizeof(quint32));
+
+	return record;
+}
+
+static inline bool syncFile(QFile *file)
+{
+	if (!file->flush())
+		return false;
+#ifdef Q_OS_WIN
+	return _commit(file->handle()) == 0;
+#else
+	return fsync(file->handle()) == 0;
+#endif
+}
+
+/* Runs on the thread pool, on copies of the records only */
+static bool writeSnapshot(QVector<QByteArray> records)
+{
+	QSaveFile snapshot(USER_DEFINED_RULE_PATH);
+
+	if (!snapshot.open(QIODevice::WriteOnly))
+		return false;
+
+	snapshot.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	               "<PropositionalEquivalences>\n");
+	for (const QByteArray &record : records)
+		snapshot.write(record);
+	snapshot.write("</PropositionalEquivalences>\n");
+
+	/* Replaces the old snapshot in one step once the data is on disk */
+	return snapshot.commit();
+}
+
+LogicSet *RuleEngine::processRecord(const QByteArray &record)
+{
+	QXmlStreamReader xml(record);
+
+	if (!xml.readNextStartElement() || xml.name() != "EquivalentStatements")
+		return nullptr;
+
+	return processStatements(&xml);
+}
+
+void RuleEngine::replayJournal()
+{
+	QFile file(USER_DEFINED_RULE_JOURNAL_PATH);
+
+	if (!file.open(QIODevice::ReadWrite)) {
+		qWarning() << "Failed to open" << file.fileName() << "-"
+		           << file.errorString();
+		return;
+	}
+
+	QByteArray contents = file.readAll();
+	int valid = 0;
+	bool damaged = false;
+
+	journalRecords = 0;
+	while (contents.size() - valid >= JOURNAL_HEADER_BYTES) {
+		const char *record = contents.constData() + valid;
+		const uchar *header = reinterpret_cast<const uchar *>(record);
+		quint32 size = qFromLittleEndian<quint32>(header);
+		quint32 sequence =
+		    qFromLittleEndian<quint32>(header + sizeof(quint32));
+		quint32 checksum =
+		    qFromLittleEndian<quint32>(header + 2 * sizeof(quint32));
+
+		/* A garbled size would make the records after it look torn */
+		if (headerChecksum(record) != checksum >> 16) {
+			damaged = true;
+			break;
+		}
+
+		/* Only the last record can be torn by a crash while appending */
+		if (size > quint32(contents.size() - valid - JOURNAL_HEADER_BYTES))
+			break;
+
+		int end = valid + JOURNAL_HEADER_BYTES + int(size);
+
+		if (recordChecksum(record, int(size)) != checksum) {
+			damaged = end < contents.size();
+			break;
+		}
+
+		if (sequence > quint32(userDefinedRecords.size())) {
+			damaged = true;
+			break;
+		}
+
+		/* Records older than the snapshot are in it already */
+		if (sequence == quint32(userDefinedRecords.size())) {
+			QByteArray payload(record + JOURNAL_HEADER_BYTES, int(size));
+			LogicSet *ruleSet = processRecord(payload);
+
+			if (ruleSet == nullptr) {
+				damaged = true;
+				break;
+			}
+
+			userDefinedRules->append(ruleSet);
+			userDefinedRecords.append(payload);
+		}
+
+		valid = end;
+		++journalRecords;
+	}
+
+	/* Whole records past a damaged one may hold rules, so the journal is
+	 * kept as it is and no longer written, see journalRuleSet */
+	if (damaged) {
+		qWarning() << "Stopped replaying" << file.fileName()
+		           << "at a damaged record, byte" << valid;
+		return;
+	}
+
+	/* Drops what a crash left of the last record, new records go after the
+	 * last whole one */
+	if (valid < contents.size())
+		file.resize(valid);
+	journalWritable = true;
+
+	if (journalRecords >= JOURNAL_COMPACTION_RECORDS)
+		startCompaction();
+}
+
+/* Rules are loaded on the thread pool but added from the GUI thread, the
+ * journal is opened by the latter once the first rule is added */
+bool RuleEngine::openJournal()
+{
+	if (journal != nullptr)
+		return journal->isOpen();
+
+	if (!journalWritable)
+		return false;
+
+	journal = new QFile(USER_DEFINED_RULE_JOURNAL_PATH);
+	if (!journal->open(QIODevice::ReadWrite)) {
+		qWarning() << "Failed to open" << journal->fileName() << "-"
+		           << journal->errorString();
+		return false;
+	}
+
+	journal->seek(journal->size());
+	return true;
+}
+
+void RuleEngine::journalRuleSet(LogicSet *ruleSet)
+{
+	finishCompaction();
+
+	int sequence = userDefinedRecords.size();
+	userDefinedRecords.append(serialiseRuleSet(ruleSet));
+
+	/* Without a journal every rule rewrites the snapshot, after one the
+	 * replay may have started */
+	if (!openJournal()) {
+		if (compacting) {
+			compaction.waitForFinished();
+			finishCompaction();
+		}
+		if (!writeSnapshot(userDefinedRecords))
+			qWarning() << "Failed to save" << USER_DEFINED_RULE_PATH;
+		return;
+	}
+
+	journal->write(journalRecord(sequence, userDefinedRecords.last()));
+	if (!syncFile(journal))
+		qWarning() << "Failed to sync" << journal->fileName();
+	++journalRecords;
+
+	if (journalRecords >= JOURNAL_COMPACTION_RECORDS)
+		startCompaction();
+}
+
+void RuleEngine::startCompaction()
+{
+	if (compacting)
+		return;
+
+	compacting = true;
+	compactedRecords = userDefinedRecords.size();
+	compaction = QtConcurrent::run(writeSnapshot, userDefinedRecords);
+}
+
+void RuleEngine::finishCompaction()
+{
+	if (!compacting || !compaction.isFinished())
+		return;
+
+	compacting = false;
+
+	/* The journal still holds every rule when the snapshot failed */
+	if (!compaction.result() || !journalWritable)
+		return;
+
+	/* Keeps the records saved while the snapshot was written */
+	if (journal != nullptr)
+		journal->close();
+
+	QSaveFile rewritten(USER_DEFINED_RULE_JOURNAL_PATH);
+
+	if (rewritten.open(QIODevice::WriteOnly)) {
+		for (int i = compactedRecords; i < userDefinedRecords.size(); ++i)
+			rewritten.write(journalRecord(i, userDefinedRecords.at(i)));
+		if (rewritten.commit())
+			journalRecords = userDefinedRecords.size() - compactedRecords;
+	}
+
+	if (journal != nullptr && journal->open(QIODevice::ReadWrite))
+		journal->seek(journal->size());
 }
 
 void RuleEngine::parseRule(QString fromFilePath,
@@ -82,12 +418,10 @@ void RuleEngine::parseRule(QString fromFilePath,
 {
 	QFile file(fromFilePath);
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		if (fromFilePath != USER_DEFINED_RULE_PATH)
-			QMessageBox::critical(nullptr, "Error", file.errorString());
-
+	/* Missing until the user saves a rule. Rules are loaded off the GUI
+	 * thread, so nothing can be shown here */
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
 		return;
-	}
 
 	QXmlStreamReader xml(&file);
 
@@ -116,14 +450,149 @@ QVector<LogicSet *> *RuleEngine::parseRuleXml()
 {
 	parseRule(USER_DEFINED_RULE_PATH, userDefinedRules);
 
+	for (LogicSet *ruleSet : *userDefinedRules)
+		userDefinedRecords.append(serialiseRuleSet(ruleSet));
+
+	replayJournal();
+
 	for (LogicSet *ruleSet : *userDefinedRules)
 		allRules->append(ruleSet);
 
-	parseRule(GENERIC_RULE_PATH, allRules);
+	loadBundledRules(allRules);
+	groupRuleSets();
+
+	for (LogicSet *ruleSet : *allRules)
+		indexRuleSet(ruleSet);
 
 	return allRules;
 }
 
+static inline QString bundledString(short index)
+{
+	return index < 0 ? QString() : QString::fromUtf8(bundledStrings[index]);
+}
+
+static inline int bundledArity(Symbol symbol)
+{
+	switch (symbol) {
+	case VARIABLE_SYMBOL:
+	case TRUTH_SYMBOL:
+	case FALSITY_SYMBOL:
+		return 0;
+	case NOT_SYMBOL:
+		return 1;
+	default:
+		return 2;
+	}
+}
+
+static Variable *buildBundledVariable(const BundledNode &node)
+{
+	QString name = bundledString(node.name);
+	QString notOccur = bundledString(node.notOccur);
+	QString mayOccur = bundledString(node.mayOccur);
+	Variable *variable = new Variable(name);
+
+	if (node.occurFree >= 0)
+		variable->setFreeVariable(bundledString(node.occurFree));
+
+	if (node.notOccurFree >= 0)
+		variable->setBoundedVariable(bundledString(node.notOccurFree));
+
+	if (!notOccur.isEmpty())
+		variable->setNotOccurVariable(notOccur);
+
+	if (!mayOccur.isEmpty())
+		variable->setMayOccurVariable(mayOccur);
+
+	return variable;
+}
+
+/* Children follow their parent, so building from the last node of the rule
+ * finds the operands of each node on top of the stack */
+static Rule *buildBundledRule(int firstNode)
+{
+	int lastNode = firstNode;
+
+	for (int needed = 1; needed > 0; ++lastNode)
+		needed += bundledArity(bundledNodes[lastNode].symbol) - 1;
+
+	QVector<Rule *> built;
+
+	for (int i = lastNode - 1; i >= firstNode; --i) {
+		const BundledNode &node = bundledNodes[i];
+		Rule *left = nullptr;
+		Rule *right = nullptr;
+
+		if (bundledArity(node.symbol) > 0)
+			left = built.takeLast();
+		if (bundledArity(node.symbol) > 1)
+			right = built.takeLast();
+
+		switch (node.symbol) {
+		case VARIABLE_SYMBOL:
+			built.append(buildBundledVariable(node));
+			break;
+		case TRUTH_SYMBOL:
+			built.append(new Truth());
+			break;
+		case FALSITY_SYMBOL:
+			built.append(new Falsity());
+			break;
+		case NOT_SYMBOL:
+			built.append(new NotStatement(left));
+			break;
+		case AND_SYMBOL:
+			built.append(new AndStatement(left, right));
+			break;
+		case OR_SYMBOL:
+			built.append(new OrStatement(left, right));
+			break;
+		case IMPLIES_SYMBOL:
+			built.append(new ImpliesStatement(left, right));
+			break;
+		case IFF_SYMBOL:
+			built.append(new IffStatement(left, right));
+			break;
+		case FORALL_SYMBOL:
+			built.append(
+			    new ForAllStatement(dynamic_cast<Variable *>(left), right));
+			break;
+		case THEREEXISTS_SYMBOL:
+			built.append(new ThereExistsStatement(
+			    dynamic_cast<Variable *>(left), right));
+			break;
+		case EQUALS_SYMBOL:
+			built.append(
+			    new EqualityStatement(dynamic_cast<Variable *>(left),
+			                          dynamic_cast<Variable *>(right)));
+			break;
+		default:
+			built.append(nullptr);
+		}
+	}
+
+	return built.last();
+}
+
+void RuleEngine::loadBundledRules(QVector<LogicSet *> *destinationRuleSet)
+{
+	for (int i = 0; i < bundledRuleSetCount; ++i) {
+		const BundledRuleSet &bundledSet = bundledRuleSets[i];
+		auto ruleSet = new LogicSet();
+
+		for (int r = bundledSet.firstRule;
+		     r < bundledSet.firstRule + bundledSet.ruleCount; ++r) {
+			Rule *rule = buildBundledRule(bundledRules[r].firstNode);
+			rule->setRuleType(bundledRules[r].leibniz);
+			ruleSet->add(rule);
+		}
+
+		ruleSet->setComment(bundledString(bundledSet.comment));
+		destinationRuleSet->append(ruleSet);
+	}
+}
+
 Rule *RuleEngine::processTruthStatement(QXmlStreamReader *xml)
 {
 	xml->skipCurrentElement();
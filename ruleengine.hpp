@@ -2,6 +2,10 @@
 #define RULEENGINE_HPP
 
 #include "logicset.hpp"
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QHash>
 #include <QXmlStreamReader>
 
 class RuleEngine
@@ -22,9 +26,38 @@ class RuleEngine
 	Rule *processEqualityStatement(QXmlStreamReader *);
 	void parseRule(QString fromFilePath,
 	               QVector<LogicSet *> *destinationRuleSet);
+	/* Builds the rule sets compiled in from equivalences.xml */
+	void loadBundledRules(QVector<LogicSet *> *destinationRuleSet);
 	QVector<LogicSet *> *userDefinedRules;
 	QVector<LogicSet *> *allRules;
-	void flushNewRuleToXml();
+	/* Every member and pair of members of the rule sets by RuleKey */
+	QHash<QByteArray, LogicSet *> ruleIndex;
+	void indexRuleSet(LogicSet *ruleSet);
+	/* Orders the rule sets so that sets of one meaning are adjacent, and
+	 * with them the alternatives offered for a subformula */
+	void groupRuleSets();
+
+	/* User defined rules are kept in a snapshot and a journal of the sets
+	 * added since. A journal record holds the XML of one set with its index
+	 * in userDefinedRules and a checksum, and is synced to disk before
+	 * addRule returns. Once the journal is long enough a new snapshot is
+	 * written in the background and the journal emptied */
+	QVector<QByteArray> userDefinedRecords;
+	/* Opened by the thread adding rules, see openJournal */
+	QFile *journal;
+	/* False when the journal could not be replayed as a whole */
+	bool journalWritable;
+	int journalRecords;
+	QFuture<bool> compaction;
+	bool compacting;
+	/* Number of sets in the snapshot being written */
+	int compactedRecords;
+	LogicSet *processRecord(const QByteArray &record);
+	void replayJournal();
+	bool openJournal();
+	void journalRuleSet(LogicSet *ruleSet);
+	void startCompaction();
+	void finishCompaction();
 	LogicSet *generateRuleSet(LogicSet *rawEquivalenceFormulas);
 	IDTable *generateRuleVariables(LogicSet *rawVariables);
 	Rule *generateNewRule(LogicStatement *rawFormula, IDTable *replaceTable);
@@ -33,6 +66,14 @@ class RuleEngine
   public:
 	QVector<LogicSet *> *parseRuleXml();
 	bool addRule(LogicStatement *formulaFrom, LogicStatement *formulaTo);
+
+	/* Returns true iff one rule set holds both formulas, up to a renaming
+	 * of their variables */
+	bool knowsRule(LogicStatement *formulaFrom, LogicStatement *formulaTo);
+
+	/* Groups the propositional rule sets by meaning, sets in one group
+	 * describe the same boolean function of their rule variables */
+	QVector<QVector<LogicSet *>> classifyRuleSets();
 	RuleEngine();
 	~RuleEngine();
 };
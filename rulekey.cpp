@@ -0,0 +1,146 @@
+#include "rulekey.hpp"
+#include "AST.hpp"
+#include "statementwalker.hpp"
+
+#include <algorithm>
+
+using namespace AST;
+
+/* Members of a run whose every order is tried, 720 orders */
+#define MAX_PERMUTED_RUN 6
+
+/* Rule with its own key */
+typedef QPair<QByteArray, LogicStatement *> Member;
+
+static inline bool keyLess(const Member &a, const Member &b)
+{
+	return a.first < b.first;
+}
+
+static inline void appendVariable(Variable *variable,
+                                  QHash<quint32, int> *numbers,
+                                  QByteArray *key)
+{
+	if (variable == nullptr) {
+		key->append('-');
+		return;
+	}
+
+	quint32 id = variable->getId();
+
+	if (!numbers->contains(id))
+		numbers->insert(id, numbers->size());
+	key->append(QByteArray::number(numbers->value(id)));
+	key->append(';');
+}
+
+void RuleKey::append(LogicStatement *rule, QHash<quint32, int> *numbers,
+                     QByteArray *key)
+{
+	StatementWalker::walk(rule, [numbers, key](LogicStatement *node,
+	                                           int stage) {
+		if (stage > 0)
+			return StatementWalker::CONTINUE;
+
+		key->append(char('a' + node->getSymbol()));
+		if (node->getSymbol() != VARIABLE_SYMBOL)
+			return StatementWalker::CONTINUE;
+
+		Variable *variable = static_cast<Variable *>(node);
+		appendVariable(variable, numbers, key);
+
+		/* Conditions name variables of the rule too */
+		if (variable->getFreeVariable() ||
+		    variable->getBoundedVariable() ||
+		    variable->getNotOccurVariable() ||
+		    variable->getMayOccurVariable()) {
+			key->append('[');
+			appendVariable(variable->getFreeVariable(), numbers, key);
+			appendVariable(variable->getBoundedVariable(), numbers, key);
+			appendVariable(variable->getNotOccurVariable(), numbers, key);
+			appendVariable(variable->getMayOccurVariable(), numbers, key);
+			key->append(']');
+		}
+
+		return StatementWalker::CONTINUE;
+	});
+}
+
+QByteArray RuleKey::of(LogicStatement *rule)
+{
+	QHash<quint32, int> numbers;
+	QByteArray key;
+
+	append(rule, &numbers, &key);
+	return key;
+}
+
+QByteArray RuleKey::ofSequence(const QVector<LogicStatement *> &rules)
+{
+	QHash<quint32, int> numbers;
+	QByteArray key;
+
+	for (LogicStatement *rule : rules) {
+		append(rule, &numbers, &key);
+		key.append('|');
+	}
+
+	return key;
+}
+
+QByteArray RuleKey::of(const QVector<LogicStatement *> &rules)
+{
+	/* Members are ordered by their own keys. Members with equal keys are
+	 * renamings of each other and their order still changes the numbering,
+	 * so every order of each such run is tried and the least key is kept.
+	 * Rules are keyed a pair of members at a time, so runs are at most two
+	 * long. Longer runs are tried in one order only, which can only make
+	 * two renamings of a set key differently, never two different sets key
+	 * the same */
+	QVector<Member> members;
+
+	for (LogicStatement *rule : rules)
+		members.append(qMakePair(of(rule), rule));
+	std::sort(members.begin(), members.end(), keyLess);
+
+	QVector<LogicStatement *> order;
+	QVector<QPair<int, int> > runs;
+
+	for (int i = 0; i < members.size(); ++i) {
+		order.append(members.at(i).second);
+		if (i > 0 && members.at(i).first == members.at(i - 1).first) {
+			if (runs.isEmpty() || runs.last().second != i)
+				runs.append(qMakePair(i - 1, i + 1));
+			else
+				runs.last().second = i + 1;
+		}
+	}
+
+	/* Odometer over the permutations of every run, each run starting from
+	 * its least permutation */
+	for (int run = runs.size() - 1; run >= 0; --run)
+		if (runs.at(run).second - runs.at(run).first > MAX_PERMUTED_RUN)
+			runs.remove(run);
+		else
+			std::sort(order.begin() + runs.at(run).first,
+			          order.begin() + runs.at(run).second);
+
+	QByteArray least = ofSequence(order);
+
+	for (int run = 0; run < runs.size();) {
+		if (std::next_permutation(order.begin() + runs.at(run).first,
+		                          order.begin() + runs.at(run).second)) {
+			QByteArray key = ofSequence(order);
+
+			if (key < least)
+				least = key;
+			run = 0;
+		} else {
+			/* Wrapped round to its least permutation, carry on to the
+			 * next run */
+			++run;
+		}
+	}
+
+	return least;
+}
@@ -0,0 +1,31 @@
+#ifndef RULEKEY_HPP
+#define RULEKEY_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+namespace AST
+{
+class LogicStatement;
+}
+
+/* Canonical keys of rules up to a consistent renaming of their variables.
+ * Variables are numbered in order of first occurrence, side conditions of
+ * rule variables included, so two keys are equal exactly when the rules
+ * are equal once the variables of one are renamed */
+class RuleKey
+{
+	static void append(AST::LogicStatement *rule, QHash<quint32, int> *numbers,
+	                   QByteArray *key);
+	static QByteArray ofSequence(const QVector<AST::LogicStatement *> &rules);
+
+  public:
+	static QByteArray of(AST::LogicStatement *rule);
+
+	/* Key of a set of rules sharing their variables, whatever the order of
+	 * the members */
+	static QByteArray of(const QVector<AST::LogicStatement *> &rules);
+};
+
+#endif // RULEKEY_HPP
@@ -0,0 +1,545 @@
+#include "satsolver.hpp"
+
+#include <algorithm>
+
+#define NO_REASON (-1)
+#define NO_CONFLICT (-1)
+#define UNASSIGNED (-1)
+#define RESTART_BASE 100
+#define ACTIVITY_DECAY 0.95
+#define ACTIVITY_LIMIT 1e100
+#define CLAUSE_ACTIVITY_DECAY 0.999
+/* Learnt clauses kept at first, as a fraction of the problem clauses */
+#define LEARNT_FRACTION (1.0 / 3)
+#define MIN_LEARNTS 100
+#define LEARNT_GROWTH 1.1
+
+SatSolver::SatSolver()
+{
+	propagationHead = 0;
+	unsatisfiable = false;
+	activityIncrement = 1.0;
+	clauseActivityIncrement = 1.0;
+	learntCount = 0;
+	maxLearnts = 0;
+}
+
+int SatSolver::newVariable()
+{
+	int variable = assignment.size();
+
+	watches.append(QVector<int>());
+	watches.append(QVector<int>());
+	assignment.append(UNASSIGNED);
+	savedPhase.append(false);
+	level.append(0);
+	reason.append(NO_REASON);
+	activity.append(0.0);
+	heapPosition.append(-1);
+	seen.append(false);
+	heapInsert(variable);
+
+	return variable;
+}
+
+int SatSolver::variableCount()
+{
+	return assignment.size();
+}
+
+int SatSolver::literalValue(int literal)
+{
+	qint8 value = assignment.at(variableOf(literal));
+
+	if (value == UNASSIGNED)
+		return UNASSIGNED;
+
+	return value ^ (literal & 1);
+}
+
+int SatSolver::decisionLevel()
+{
+	return trailLimit.size();
+}
+
+void SatSolver::enqueue(int literal, int reasonClause)
+{
+	int variable = variableOf(literal);
+
+	assignment[variable] = (literal & 1) ? 0 : 1;
+	level[variable] = decisionLevel();
+	reason[variable] = reasonClause;
+	trail.append(literal);
+}
+
+int SatSolver::attachClause(const QVector<int> &literals, bool learnt)
+{
+	int index = clauses.size();
+
+	clauses.append(Clause{literals, learnt, 0.0});
+	watches[literals.at(0)].append(index);
+	watches[literals.at(1)].append(index);
+
+	if (learnt) {
+		++learntCount;
+		bumpClauseActivity(index);
+	}
+
+	return index;
+}
+
+bool SatSolver::addClause(QVector<int> literals)
+{
+	if (unsatisfiable)
+		return false;
+
+	/* Drop duplicate and false literals, detect tautologies and satisfied
+	 * clauses, everything here is at decision level 0 */
+	QVector<int> simplified;
+
+	for (int literal : literals) {
+		int value = literalValue(literal);
+
+		if (value == 1 || simplified.contains(negate(literal)))
+			return true;
+
+		if (value == UNASSIGNED && !simplified.contains(literal))
+			simplified.append(literal);
+	}
+
+	if (simplified.isEmpty()) {
+		unsatisfiable = true;
+		return false;
+	}
+
+	if (simplified.size() == 1) {
+		enqueue(simplified.front(), NO_REASON);
+		if (propagate() != NO_CONFLICT)
+			unsatisfiable = true;
+
+		return !unsatisfiable;
+	}
+
+	attachClause(simplified, false);
+	return true;
+}
+
+int SatSolver::propagate()
+{
+	int conflict = NO_CONFLICT;
+
+	while (conflict == NO_CONFLICT && propagationHead < trail.size()) {
+		int falseLiteral = negate(trail.at(propagationHead++));
+		QVector<int> &watchList = watches[falseLiteral];
+		int i = 0;
+		int j = 0;
+
+		while (i < watchList.size()) {
+			int clauseIndex = watchList.at(i++);
+			QVector<int> &literals = clauses[clauseIndex].literals;
+
+			/* Keep the false literal in the second watch */
+			if (literals.at(0) == falseLiteral) {
+				literals[0] = literals.at(1);
+				literals[1] = falseLiteral;
+			}
+
+			if (literalValue(literals.at(0)) == 1) {
+				watchList[j++] = clauseIndex;
+				continue;
+			}
+
+			/* Look for a new literal to watch */
+			bool moved = false;
+			for (int k = 2; k < literals.size(); ++k)
+				if (literalValue(literals.at(k)) != 0) {
+					literals[1] = literals.at(k);
+					literals[k] = falseLiteral;
+					watches[literals.at(1)].append(clauseIndex);
+					moved = true;
+					break;
+				}
+
+			if (moved)
+				continue;
+
+			/* Clause is unit or conflicting */
+			watchList[j++] = clauseIndex;
+
+			if (literalValue(literals.at(0)) == 0) {
+				conflict = clauseIndex;
+				while (i < watchList.size())
+					watchList[j++] = watchList.at(i++);
+			} else
+				enqueue(literals.at(0), clauseIndex);
+		}
+
+		watchList.resize(j);
+	}
+
+	return conflict;
+}
+
+void SatSolver::analyze(int conflict, QVector<int> &learnt,
+                        int &backtrackLevel)
+{
+	int pathCount = 0;
+	int implied = -1;
+	int trailIndex = trail.size() - 1;
+	int clauseIndex = conflict;
+
+	/* Slot for the asserting literal */
+	learnt.append(-1);
+
+	do {
+		if (clauses.at(clauseIndex).learnt)
+			bumpClauseActivity(clauseIndex);
+
+		const QVector<int> &literals = clauses.at(clauseIndex).literals;
+
+		/* The implied literal of a reason clause sits in the first slot */
+		for (int k = (implied == -1 ? 0 : 1); k < literals.size(); ++k) {
+			int variable = variableOf(literals.at(k));
+
+			if (!seen.at(variable) && level.at(variable) > 0) {
+				seen[variable] = true;
+				bumpActivity(variable);
+
+				if (level.at(variable) >= decisionLevel())
+					++pathCount;
+				else
+					learnt.append(literals.at(k));
+			}
+		}
+
+		/* Walk back the trail to the next literal involved in the conflict */
+		while (!seen.at(variableOf(trail.at(trailIndex))))
+			--trailIndex;
+
+		implied = trail.at(trailIndex--);
+		clauseIndex = reason.at(variableOf(implied));
+		seen[variableOf(implied)] = false;
+		--pathCount;
+	} while (pathCount > 0);
+
+	learnt[0] = negate(implied);
+
+	/* Backtrack to the second highest level in the learnt clause, keeping
+	 * that literal in the second watch */
+	backtrackLevel = 0;
+	int secondWatch = 1;
+	for (int k = 1; k < learnt.size(); ++k) {
+		int literalLevel = level.at(variableOf(learnt.at(k)));
+		if (literalLevel > backtrackLevel) {
+			backtrackLevel = literalLevel;
+			secondWatch = k;
+		}
+	}
+
+	if (learnt.size() > 1) {
+		int swap = learnt.at(1);
+		learnt[1] = learnt.at(secondWatch);
+		learnt[secondWatch] = swap;
+	}
+
+	for (int k = 1; k < learnt.size(); ++k)
+		seen[variableOf(learnt.at(k))] = false;
+}
+
+void SatSolver::cancelUntil(int targetLevel)
+{
+	if (decisionLevel() <= targetLevel)
+		return;
+
+	for (int k = trail.size() - 1; k >= trailLimit.at(targetLevel); --k) {
+		int variable = variableOf(trail.at(k));
+
+		savedPhase[variable] = assignment.at(variable) == 1;
+		assignment[variable] = UNASSIGNED;
+		reason[variable] = NO_REASON;
+
+		if (!heapContains(variable))
+			heapInsert(variable);
+	}
+
+	trail.resize(trailLimit.at(targetLevel));
+	trailLimit.resize(targetLevel);
+	propagationHead = trail.size();
+}
+
+int SatSolver::pickBranchLiteral()
+{
+	while (!heap.isEmpty()) {
+		int variable = heapRemoveMax();
+
+		if (assignment.at(variable) == UNASSIGNED)
+			return literal(variable, !savedPhase.at(variable));
+	}
+
+	return -1;
+}
+
+SatSolver::SearchResult SatSolver::search(int conflictBudget)
+{
+	int conflicts = 0;
+
+	for (;;) {
+		int conflict = propagate();
+
+		if (conflict != NO_CONFLICT) {
+			++conflicts;
+
+			if (decisionLevel() == 0)
+				return UNSATISFIABLE;
+
+			QVector<int> learnt;
+			int backtrackLevel;
+
+			analyze(conflict, learnt, backtrackLevel);
+			cancelUntil(backtrackLevel);
+
+			if (learnt.size() == 1)
+				enqueue(learnt.front(), NO_REASON);
+			else
+				enqueue(learnt.front(), attachClause(learnt, true));
+
+			decayActivity();
+		} else {
+			if (conflicts >= conflictBudget)
+				return UNDECIDED;
+
+			if (learntCount - trail.size() >= maxLearnts)
+				reduceLearnts();
+
+			int decision = pickBranchLiteral();
+
+			/* Every variable assigned without conflict */
+			if (decision == -1)
+				return SATISFIABLE;
+
+			trailLimit.append(trail.size());
+			enqueue(decision, NO_REASON);
+		}
+	}
+}
+
+bool SatSolver::solve()
+{
+	if (unsatisfiable)
+		return false;
+
+	SearchResult result = UNDECIDED;
+
+	if (maxLearnts == 0)
+		maxLearnts =
+		    qMax(double(MIN_LEARNTS), clauses.size() * LEARNT_FRACTION);
+
+	for (int restart = 0; result == UNDECIDED; ++restart) {
+		result = search(luby(restart) * RESTART_BASE);
+		maxLearnts *= LEARNT_GROWTH;
+
+		if (result == SATISFIABLE)
+			model = assignment;
+
+		cancelUntil(0);
+	}
+
+	if (result == UNSATISFIABLE)
+		unsatisfiable = true;
+
+	return result == SATISFIABLE;
+}
+
+bool SatSolver::modelValue(int variable)
+{
+	return model.value(variable, 0) == 1;
+}
+
+int SatSolver::luby(int index)
+{
+	/* Finite subsequences of the Luby sequence 1 1 2 1 1 2 4 ... */
+	int size = 1;
+	int sequence = 0;
+
+	while (size < index + 1) {
+		++sequence;
+		size = 2 * size + 1;
+	}
+
+	while (size - 1 != index) {
+		size = (size - 1) >> 1;
+		--sequence;
+		index = index % size;
+	}
+
+	return 1 << sequence;
+}
+
+void SatSolver::bumpActivity(int variable)
+{
+	activity[variable] += activityIncrement;
+
+	if (activity.at(variable) > ACTIVITY_LIMIT) {
+		for (double &value : activity)
+			value /= ACTIVITY_LIMIT;
+		activityIncrement /= ACTIVITY_LIMIT;
+	}
+
+	if (heapContains(variable))
+		heapPercolateUp(heapPosition.at(variable));
+}
+
+void SatSolver::decayActivity()
+{
+	activityIncrement /= ACTIVITY_DECAY;
+	clauseActivityIncrement /= CLAUSE_ACTIVITY_DECAY;
+}
+
+void SatSolver::bumpClauseActivity(int clauseIndex)
+{
+	clauses[clauseIndex].activity += clauseActivityIncrement;
+
+	if (clauses.at(clauseIndex).activity > ACTIVITY_LIMIT) {
+		for (Clause &clause : clauses)
+			if (clause.learnt)
+				clause.activity /= ACTIVITY_LIMIT;
+		clauseActivityIncrement /= ACTIVITY_LIMIT;
+	}
+}
+
+/* A clause that is the reason of an assignment on the trail */
+bool SatSolver::isLocked(int clauseIndex)
+{
+	int implied = clauses.at(clauseIndex).literals.at(0);
+
+	return reason.at(variableOf(implied)) == clauseIndex &&
+	       literalValue(implied) == 1;
+}
+
+/* Deletes the less active half of the learnt clauses longer than two that
+ * are no reason for an assignment, then renumbers the clauses, watch lists
+ * and reasons */
+void SatSolver::reduceLearnts()
+{
+	QVector<int> candidates;
+
+	/* Binary clauses cost little to keep and propagate the most */
+	for (int i = 0; i < clauses.size(); ++i)
+		if (clauses.at(i).learnt && clauses.at(i).literals.size() > 2 &&
+		    !isLocked(i))
+			candidates.append(i);
+
+	std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+		return clauses.at(a).activity < clauses.at(b).activity;
+	});
+
+	int deletions = candidates.size() / 2;
+	QVector<bool> deleted(clauses.size(), false);
+
+	for (int i = 0; i < deletions; ++i)
+		deleted[candidates.at(i)] = true;
+
+	QVector<int> renumbered(clauses.size(), NO_REASON);
+	QVector<Clause> kept;
+
+	kept.reserve(clauses.size() - deletions);
+	for (int i = 0; i < clauses.size(); ++i)
+		if (!deleted.at(i)) {
+			renumbered[i] = kept.size();
+			kept.append(clauses.at(i));
+		}
+
+	clauses.swap(kept);
+	learntCount -= deletions;
+
+	/* The watched literals stay in the first two slots, so the lists are
+	 * rebuilt as they were without the deleted clauses */
+	for (QVector<int> &watchList : watches)
+		watchList.clear();
+	for (int i = 0; i < clauses.size(); ++i) {
+		watches[clauses.at(i).literals.at(0)].append(i);
+		watches[clauses.at(i).literals.at(1)].append(i);
+	}
+
+	for (int literal : trail) {
+		int &clauseIndex = reason[variableOf(literal)];
+
+		if (clauseIndex != NO_REASON)
+			clauseIndex = renumbered.at(clauseIndex);
+	}
+}
+
+bool SatSolver::heapContains(int variable)
+{
+	return heapPosition.at(variable) >= 0;
+}
+
+void SatSolver::heapInsert(int variable)
+{
+	heapPosition[variable] = heap.size();
+	heap.append(variable);
+	heapPercolateUp(heap.size() - 1);
+}
+
+int SatSolver::heapRemoveMax()
+{
+	int top = heap.front();
+	int last = heap.back();
+
+	heap.removeLast();
+	heapPosition[top] = -1;
+
+	if (!heap.isEmpty()) {
+		heap[0] = last;
+		heapPosition[last] = 0;
+		heapPercolateDown(0);
+	}
+
+	return top;
+}
+
+void SatSolver::heapPercolateUp(int position)
+{
+	int variable = heap.at(position);
+
+	while (position > 0) {
+		int parent = (position - 1) >> 1;
+
+		if (activity.at(heap.at(parent)) >= activity.at(variable))
+			break;
+
+		heap[position] = heap.at(parent);
+		heapPosition[heap.at(position)] = position;
+		position = parent;
+	}
+
+	heap[position] = variable;
+	heapPosition[variable] = position;
+}
+
+void SatSolver::heapPercolateDown(int position)
+{
+	int variable = heap.at(position);
+	int size = heap.size();
+
+	for (;;) {
+		int child = 2 * position + 1;
+
+		if (child >= size)
+			break;
+
+		if (child + 1 < size &&
+		    activity.at(heap.at(child + 1)) > activity.at(heap.at(child)))
+			++child;
+
+		if (activity.at(heap.at(child)) <= activity.at(variable))
+			break;
+
+		heap[position] = heap.at(child);
+		heapPosition[heap.at(position)] = position;
+		position = child;
+	}
+
+	heap[position] = variable;
+	heapPosition[variable] = position;
+}
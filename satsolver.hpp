@@ -0,0 +1,106 @@
+#ifndef SATSOLVER_HPP
+#define SATSOLVER_HPP
+
+#include <QVector>
+
+/* Self-contained CDCL solver: two watched literals, first UIP learning,
+ * activity based branching with phase saving, Luby restarts and deletion of
+ * the least active learnt clauses. A literal is
+ * 2 * variable for the positive and 2 * variable + 1 for the negative
+ * occurrence */
+class SatSolver
+{
+	struct Clause
+	{
+		QVector<int> literals;
+		bool learnt;
+		double activity;
+	};
+
+	enum SearchResult { SATISFIABLE, UNSATISFIABLE, UNDECIDED };
+
+	QVector<Clause> clauses;
+	/* Clauses watching a literal, visited when that literal becomes false */
+	QVector<QVector<int> > watches;
+	/* -1 unassigned, 0 false, 1 true */
+	QVector<qint8> assignment;
+	QVector<qint8> model;
+	QVector<bool> savedPhase;
+	QVector<int> level;
+	QVector<int> reason;
+	QVector<int> trail;
+	QVector<int> trailLimit;
+	int propagationHead;
+	bool unsatisfiable;
+
+	QVector<double> activity;
+	double activityIncrement;
+	/* Binary max-heap of variables ordered by activity */
+	QVector<int> heap;
+	QVector<int> heapPosition;
+
+	QVector<bool> seen;
+
+	double clauseActivityIncrement;
+	int learntCount;
+	/* Learnt clauses kept before the least active half is deleted, grows
+	 * with every restart */
+	double maxLearnts;
+
+	int literalValue(int literal);
+	int decisionLevel();
+	void enqueue(int literal, int reasonClause);
+	int propagate();
+	void analyze(int conflict, QVector<int> &learnt, int &backtrackLevel);
+	void cancelUntil(int targetLevel);
+	int attachClause(const QVector<int> &literals, bool learnt);
+	int pickBranchLiteral();
+	SearchResult search(int conflictBudget);
+
+	void bumpActivity(int variable);
+	void decayActivity();
+	void bumpClauseActivity(int clauseIndex);
+	bool isLocked(int clauseIndex);
+	void reduceLearnts();
+	bool heapContains(int variable);
+	void heapInsert(int variable);
+	int heapRemoveMax();
+	void heapPercolateUp(int position);
+	void heapPercolateDown(int position);
+
+	static int luby(int index);
+
+  public:
+	SatSolver();
+
+	/* Allocates a fresh variable and returns its index */
+	int newVariable();
+	int variableCount();
+
+	static inline int literal(int variable, bool negated)
+	{
+		return 2 * variable + (negated ? 1 : 0);
+	}
+
+	static inline int negate(int literal)
+	{
+		return literal ^ 1;
+	}
+
+	static inline int variableOf(int literal)
+	{
+		return literal >> 1;
+	}
+
+	/* Adds a clause at decision level 0, returns false once the clause set
+	 * is known to be unsatisfiable */
+	bool addClause(QVector<int> literals);
+
+	/* Returns true iff the clause set is satisfiable */
+	bool solve();
+
+	/* Value of a variable in the model found by the last successful solve */
+	bool modelValue(int variable);
+};
+
+#endif // SATSOLVER_HPP
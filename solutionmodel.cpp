@@ -1,4 +1,5 @@
 #include "solutionmodel.hpp"
+#include "batchparser.hpp"
 
 #include <QTextStream>
 #include <QDebug>
@@ -7,35 +8,47 @@ using AST::LogicStatement;
 
 solutionModel::solutionModel(LogicStatement *begin, LogicStatement *end)
 {
-	forwardStack << begin;
-	backwardStack << end;
+	/* The model takes ownership of begin and end, only their interned form
+	 * is kept */
+	forwardStack << Formula::fromStatement(begin);
+	backwardStack << Formula::fromStatement(end);
+	delete begin;
+	delete end;
 }
 
 solutionModel::solutionModel(QFile *f)
 {
-	QTextStream in(f);
+	BatchParser batch;
 
-	for (QString line; !(line = in.readLine()).isEmpty();) {
-		forwardStack << AST::parse(line);
-	}
-	while (!in.atEnd()) {
-		QString line = in.readLine();
-		backwardStack << AST::parse(line);
-	}
+	if (!batch.parse(f))
+		qWarning() << "Failed to read" << f->fileName();
+
+	for (const BatchParser::Failure &failure : batch.failures())
+		qWarning() << "Skipping line" << failure.line << "of" << f->fileName()
+		           << "-" << failure.message;
+
+	/* Forward lines come first, an empty line separates them from the
+	 * backward ones. Lines without a formula, those that failed to parse and
+	 * blank ones after the separator, are left out */
+	int line = 0;
+
+	for (; line < batch.lineCount() && !batch.isEmpty(line); ++line)
+		if (batch.statement(line) != nullptr)
+			forwardStack << Formula::fromStatement(batch.statement(line));
+
+	for (++line; line < batch.lineCount(); ++line)
+		if (batch.statement(line) != nullptr)
+			backwardStack << Formula::fromStatement(batch.statement(line));
 }
 
 solutionModel::~solutionModel()
 {
-	for (LogicStatement *s : forwardStack) {
-		delete s;
-	}
-	for (LogicStatement *s : backwardStack) {
-		delete s;
-	}
+	/* Operations only hold handles, the lines are freed by the graph */
+	qDeleteAll(undoStack);
 	clearRedoStack();
 }
 
-void solutionModel::add(bool forward, LogicStatement *formula)
+void solutionModel::add(bool forward, const Formula &formula)
 {
 	clearRedoStack();
 	if (forward) {
@@ -43,39 +56,33 @@ void solutionModel::add(bool forward, LogicStatement *formula)
 	} else {
 		backwardStack.push(formula);
 	}
-	QVector<LogicStatement *> v;
+	QVector<Formula> v;
 	v.append(formula);
 	undoStack.push(new Operation{ true, forward, v });
 }
 
 void solutionModel::remove(bool forward, int n)
 {
-	QStack<LogicStatement *> *stack = forward ? &forwardStack : &backwardStack;
-	QVector<LogicStatement *> removedlist;
+	QStack<Formula> *stack = forward ? &forwardStack : &backwardStack;
+	QVector<Formula> removedlist;
 	for (int i = stack->size() - 1; i >= n; i--) {
 		removedlist.append(stack->pop());
 	}
 	undoStack.push(new Operation{ false, forward, removedlist });
 }
 
-void solutionModel::remove(LogicStatement *item)
+void solutionModel::removeLine(bool forward, int row)
 {
-	int row;
-	bool isForward;
-	if ((row = forwardStack.indexOf(item)) != -1) {
-		isForward = true;
-	} else if ((row = backwardStack.indexOf(item)) != -1) {
-		isForward = false;
-	}
+	QStack<Formula> *stack = forward ? &forwardStack : &backwardStack;
 	if (row == 0) {
 		// Cannot remove begin/end formulae
 		return;
 	}
-	if (row > 0) {
-		remove(isForward, row);
+	if (row > 0 && row < stack->size()) {
+		remove(forward, row);
 		return;
 	}
-	qWarning() << "Removing a non-existant LogicStatement from model";
+	qWarning() << "Removing a non-existant line from model";
 }
 
 void solutionModel::undo()
@@ -84,13 +91,13 @@ void solutionModel::undo()
 		return;
 
 	Operation *o = undoStack.pop();
-	QStack<LogicStatement *> *tostack =
-	    o->forward ? &forwardStack : &backwardStack;
+	QStack<Formula> *tostack = o->forward ? &forwardStack : &backwardStack;
 	if (o->add) {
 		tostack->pop();
 	} else {
-		for (LogicStatement *i : o->stats) {
-			tostack->push(i);
+		/* remove() recorded the lines from the last one up */
+		for (int i = o->stats.size() - 1; i >= 0; i--) {
+			tostack->push(o->stats.at(i));
 		}
 	}
 	redoStack.push(o);
@@ -102,8 +109,7 @@ void solutionModel::redo()
 		return;
 
 	Operation *o = redoStack.pop();
-	QStack<LogicStatement *> *tostack =
-	    o->forward ? &forwardStack : &backwardStack;
+	QStack<Formula> *tostack = o->forward ? &forwardStack : &backwardStack;
 	if (o->add) {
 		tostack->push(o->stats.at(0));
 	} else {
@@ -114,42 +120,38 @@ void solutionModel::redo()
 	undoStack.push(o);
 }
 
-bool solutionModel::isDuplicate(LogicStatement *lstat, bool isForward)
+bool solutionModel::isDuplicate(const Formula &formula, bool isForward)
 {
-	QStack<LogicStatement *> *tostack =
-	    isForward ? &forwardStack : &backwardStack;
-	for (LogicStatement *l : *tostack) {
-		if (l->equals(lstat)) {
-			return true;
-		}
-	}
-	return false;
+	QStack<Formula> *tostack = isForward ? &forwardStack : &backwardStack;
+	return tostack->contains(formula);
+}
+
+Formula solutionModel::rewrite(bool forward, const FormulaPath &path,
+                               const Formula &replacement)
+{
+	QStack<Formula> *stack = forward ? &forwardStack : &backwardStack;
+	return path.replaced(stack->top(), replacement);
 }
 
 bool solutionModel::proofFinished()
 {
-	return forwardStack.top()->equals(backwardStack.top());
+	return forwardStack.top() == backwardStack.top();
 }
 
 void solutionModel::saveToFile(QFile *f)
 {
 	QTextStream out(f);
-	for (LogicStatement *l : forwardStack) {
-		out << l->print(true) << "\n";
+	for (const Formula &l : forwardStack) {
+		out << l.print(true) << "\n";
 	}
 	out << "\n";
-	for (LogicStatement *l : backwardStack) {
-		out << l->print(true) << "\n";
+	for (const Formula &l : backwardStack) {
+		out << l.print(true) << "\n";
 	}
 }
 
 void solutionModel::clearRedoStack()
 {
-	for (Operation *o : redoStack) {
-		for (LogicStatement *s : o->stats) {
-			delete s;
-		}
-		delete o;
-	}
+	qDeleteAll(redoStack);
 	redoStack.clear();
 }
@@ -5,12 +5,14 @@
 #include <QStack>
 
 #include "AST.hpp"
+#include "formuladag.hpp"
+#include "formulapath.hpp"
 
 struct Operation
 {
 	bool add : 1;
 	bool forward : 1;
-	QVector<AST::LogicStatement *> stats;
+	QVector<Formula> stats;
 };
 
 class solutionModel
@@ -23,17 +25,23 @@ class solutionModel
 	solutionModel(QFile *f);
 	~solutionModel();
 
-	QStack<AST::LogicStatement *> forwardStack;
-	QStack<AST::LogicStatement *> backwardStack;
+	/* Proof lines are handles into the shared formula graph, a line derived
+	 * by a rewrite shares every untouched subformula with the line before */
+	QStack<Formula> forwardStack;
+	QStack<Formula> backwardStack;
 
 	void undo();
 	void redo();
-	void add(bool forward, AST::LogicStatement *formula);
+	void add(bool forward, const Formula &formula);
 	void remove(bool forward, int n);
-	void remove(AST::LogicStatement *item);
+	void removeLine(bool forward, int row);
 
 	bool proofFinished();
-	bool isDuplicate(AST::LogicStatement *lsta, bool isForward);
+	bool isDuplicate(const Formula &formula, bool isForward);
+
+	/* Last line of the given side with the subformula at path replaced */
+	Formula rewrite(bool forward, const FormulaPath &path,
+	                const Formula &replacement);
 
 	void saveToFile(QFile *f);
 
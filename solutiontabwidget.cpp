@@ -4,6 +4,7 @@
 #include "subformulaselectiondialog.hpp"
 #include "replacementinputdialog.hpp"
 #include "formulareplacementdialog.hpp"
+#include "parsecache.hpp"
 #include "ui_solutiontabwidget.h"
 
 #include <QClipboard>
@@ -14,10 +15,12 @@
 class SolutionTabWidget::FormulaWidgetItem : public QListWidgetItem
 {
   public:
-	LogicStatement *lstat;
-	FormulaWidgetItem(const QString &text, LogicStatement *lstat,
-	                  QListWidget *view = nullptr)
-	    : QListWidgetItem(text, view), lstat(lstat)
+	Formula line;
+	bool forward;
+	int row;
+	FormulaWidgetItem(const QString &text, const Formula &line, bool forward,
+	                  int row, QListWidget *view = nullptr)
+	    : QListWidgetItem(text, view), line(line), forward(forward), row(row)
 	{
 	}
 };
@@ -25,7 +28,7 @@ class SolutionTabWidget::FormulaWidgetItem : public QListWidgetItem
 SolutionTabWidget::SolutionTabWidget(AST::LogicStatement *begin,
                                      AST::LogicStatement *end, QWidget *parent)
     : QWidget(parent), ui(new Ui::SolutionTabWidget),
-      model(new solutionModel(begin, end))
+      model(new solutionModel(begin, end)), selectedFormula(nullptr)
 {
 	ui->setupUi(this);
 
@@ -38,7 +41,7 @@ SolutionTabWidget::SolutionTabWidget(AST::LogicStatement *begin,
 
 SolutionTabWidget::SolutionTabWidget(QFile *f, QWidget *parent)
     : QWidget(parent), ui(new Ui::SolutionTabWidget),
-      model(new solutionModel(f))
+      model(new solutionModel(f)), selectedFormula(nullptr)
 {
 	ui->setupUi(this);
 
@@ -51,6 +54,7 @@ SolutionTabWidget::SolutionTabWidget(QFile *f, QWidget *parent)
 
 SolutionTabWidget::~SolutionTabWidget()
 {
+	delete selectedFormula;
 	delete model;
 	delete ui;
 }
@@ -63,42 +67,39 @@ void SolutionTabWidget::redraw()
 
 	bool proofFinished = model->proofFinished();
 
-	QVectorIterator<AST::LogicStatement *> forwardStackIt(model->forwardStack);
-	QVectorIterator<AST::LogicStatement *> backwardStackIt(
-	    model->backwardStack);
-	backwardStackIt.toBack();
+	int forwardSize = model->forwardStack.size();
+	int backwardSize = model->backwardStack.size();
 
 	if (!proofFinished) {
-		while (forwardStackIt.hasNext()) {
-			LogicStatement *lstat = forwardStackIt.next();
+		for (int row = 0; row < forwardSize; row++) {
+			const Formula &line = model->forwardStack.at(row);
 			FormulaWidgetItem *w = new FormulaWidgetItem(
-			    lstat->print(ET::fullBracket).append("\n"), lstat,
+			    line.print(ET::fullBracket).append("\n"), line, true, row,
 			    ui->listWidget);
 			ui->listWidget->addItem(w);
 		}
 		ui->listWidget->addItem("\n");
-		while (backwardStackIt.hasPrevious()) {
-			LogicStatement *lstat = backwardStackIt.previous();
+		for (int row = backwardSize - 1; row >= 0; row--) {
+			const Formula &line = model->backwardStack.at(row);
 			FormulaWidgetItem *w = new FormulaWidgetItem(
-			    lstat->print(ET::fullBracket).append("\n"), lstat,
+			    line.print(ET::fullBracket).append("\n"), line, false, row,
 			    ui->listWidget);
 			ui->listWidget->addItem(w);
 		}
 		connect(ui->listWidget, SIGNAL(itemClicked(QListWidgetItem *)), this,
 		        SLOT(lineSelected(QListWidgetItem *)));
 	} else {
-		while (forwardStackIt.hasNext()) {
-			LogicStatement *lstat = forwardStackIt.next();
+		for (int row = 0; row < forwardSize; row++) {
+			const Formula &line = model->forwardStack.at(row);
 			FormulaWidgetItem *w = new FormulaWidgetItem(
-			    lstat->print(ET::fullBracket).append("\n"), lstat,
+			    line.print(ET::fullBracket).append("\n"), line, true, row,
 			    ui->listWidget);
 			ui->listWidget->addItem(w);
 		}
-		backwardStackIt.previous();
-		while (backwardStackIt.hasPrevious()) {
-			LogicStatement *lstat = backwardStackIt.previous();
+		for (int row = backwardSize - 2; row >= 0; row--) {
+			const Formula &line = model->backwardStack.at(row);
 			FormulaWidgetItem *w = new FormulaWidgetItem(
-			    lstat->print(ET::fullBracket).append("\n"), lstat,
+			    line.print(ET::fullBracket).append("\n"), line, false, row,
 			    ui->listWidget);
 			ui->listWidget->addItem(w);
 		}
@@ -117,29 +118,29 @@ void SolutionTabWidget::lineSelected(QListWidgetItem *item)
 {
 	int lineno = ui->listWidget->row(item);
 	if (lineno == model->forwardStack.size() - 1) {
-		selectedFormula = model->forwardStack.top();
 		isForward = true;
 	} else if (lineno == model->forwardStack.size() + 1) {
-		selectedFormula = model->backwardStack.top();
 		isForward = false;
 	} else {
 		// Blank line, do nothing and return
 		return;
 	}
-	selectedFormula = selectedFormula->clone();
+	delete selectedFormula;
+	selectedFormula = isForward ? model->forwardStack.top().toStatement()
+	                            : model->backwardStack.top().toStatement();
 	auto dialog = new SubformulaSelectionDialog(selectedFormula, this);
-	connect(dialog, SIGNAL(subformulaSelected(AST::LogicStatement *)), this,
-	        SLOT(subformulaSelected(AST::LogicStatement *)));
+	connect(dialog, SIGNAL(subformulaSelected(const FormulaPath &)), this,
+	        SLOT(subformulaSelected(const FormulaPath &)));
 	dialog->setAttribute(Qt::WA_DeleteOnClose);
 	dialog->setWindowFlags(Qt::FramelessWindowHint | Qt::Popup);
 	dialog->show();
 }
 
-void SolutionTabWidget::subformulaSelected(AST::LogicStatement *subformula)
+void SolutionTabWidget::subformulaSelected(const FormulaPath &path)
 {
-	selectedSubformula = subformula;
+	selectedPath = path;
 
-	auto d = new FormulaReplacementDialog(subformula, this);
+	auto d = new FormulaReplacementDialog(path.get(selectedFormula), this);
 	connect(d, SIGNAL(ruleSelected(LogicSet *)), this,
 	        SLOT(ruleSelected(LogicSet *)));
 	d->setAttribute(Qt::WA_DeleteOnClose);
@@ -149,8 +150,8 @@ void SolutionTabWidget::subformulaSelected(AST::LogicStatement *subformula)
 
 void SolutionTabWidget::ruleSelected(LogicSet *ruleset)
 {
-	QVector<Rule *> *m =
-	    ET::eqEng->getMatchedRules(selectedSubformula, ruleset);
+	QVector<Rule *> *m = ET::eqEng()->getMatchedRules(
+	    selectedPath.get(selectedFormula), ruleset);
 	auto d = new MatchedRuleSelectionDialog(m, ruleset, this);
 	connect(d, SIGNAL(ruleSelected(Rule *, Rule *)), this,
 	        SLOT(matchedRuleSelected(Rule *, Rule *)));
@@ -161,19 +162,20 @@ void SolutionTabWidget::ruleSelected(LogicSet *ruleset)
 
 void SolutionTabWidget::matchedRuleSelected(Rule *from, Rule *to)
 {
-	LogicStatement *newSubFormula =
-	    ET::eqEng->replaceStatement(selectedSubformula, from, to, this);
+	selectedFormula = ET::eqEng()->replaceStatement(
+	    selectedFormula, selectedPath, from, to, this);
 
-	if (selectedSubformula == selectedFormula) {
-		newFormulaGenerated(newSubFormula);
-	} else {
-		selectedFormula->replaceChildStatement(selectedSubformula,
-		                                       newSubFormula);
-		newFormulaGenerated(selectedFormula);
-	}
+	/* Only the spine down to the rewritten subformula is new, the rest of
+	 * the line is shared with the one it was derived from */
+	Formula replacement =
+	    Formula::fromStatement(selectedPath.get(selectedFormula));
+	delete selectedFormula;
+	selectedFormula = nullptr;
+
+	newFormulaGenerated(model->rewrite(isForward, selectedPath, replacement));
 }
 
-void SolutionTabWidget::newFormulaGenerated(AST::LogicStatement *formula)
+void SolutionTabWidget::newFormulaGenerated(const Formula &formula)
 {
 	bool isDuplicate = model->isDuplicate(formula, isForward);
 	model->add(isForward, formula);
@@ -207,7 +209,10 @@ LogicStatement *SolutionTabWidget::getReplacement(QString &prefixMessage,
 	while (input == nullptr) {
 		QString inputStr =
 		    ReplacementInputDialog::getString(reqMsg, errorMessage, this);
-		input = AST::parse(inputStr);
+		Formula formula = ParseCache::globalCache()->parse(inputStr);
+
+		if (!formula.isNull())
+			input = formula.toStatement();
 	}
 
 	return input;
@@ -233,9 +238,9 @@ void SolutionTabWidget::ShowContextMenu(const QPoint &point)
 	if (selectedItem) {
 		if (selectedItem->text() == "Copy") {
 			QApplication::clipboard()->setText(
-			    fitem->lstat->print(ET::fullBracket));
+			    fitem->line.print(ET::fullBracket));
 		} else if (selectedItem->text() == "Remove") {
-			model->remove(fitem->lstat);
+			model->removeLine(fitem->forward, fitem->row);
 			redraw();
 		}
 	}
@@ -244,8 +249,25 @@ void SolutionTabWidget::ShowContextMenu(const QPoint &point)
 void SolutionTabWidget::saveRule()
 {
 	if (model->proofFinished()) {
-		ET::eqEng->addNewPropositionalEquivalence(model->forwardStack.first(),
-		                                          model->backwardStack.first());
+		/* The engine keeps propositional rules it does not know yet, the
+		 * others stay ours to free */
+		LogicStatement *from = model->forwardStack.first().toStatement();
+		LogicStatement *to = model->backwardStack.first().toStatement();
+		bool firstOrder = from->isFirstOrderLogic() || to->isFirstOrderLogic();
+		bool known = !firstOrder && ET::eqEng()->knowsEquivalence(from, to);
+
+		if (firstOrder || known) {
+			delete from;
+			delete to;
+		} else {
+			ET::eqEng()->addNewPropositionalEquivalence(from, to);
+		}
+
+		if (known) {
+			QMessageBox msgBox(this);
+			msgBox.setText("The rule base already has this equivalence.");
+			msgBox.exec();
+		}
 	} else {
 		QMessageBox msgBox(this);
 		msgBox.setText("You need to prove the equivalence first.");
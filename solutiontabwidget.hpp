@@ -25,7 +25,8 @@ class SolutionTabWidget : public QWidget
 	 *  save states globally so that no need to pass them all the time.
 	 */
 	bool isForward;
-	AST::LogicStatement *selectedSubformula;
+	FormulaPath selectedPath;
+	/* Scratch copy of the selected line the subformula is picked from */
 	AST::LogicStatement *selectedFormula;
 
   public:
@@ -53,10 +54,10 @@ signals:
   private
 slots:
 	void lineSelected(QListWidgetItem *item);
-	void subformulaSelected(AST::LogicStatement *subformula);
+	void subformulaSelected(const FormulaPath &path);
 	void ruleSelected(LogicSet *ruleset);
 	void matchedRuleSelected(Rule *from, Rule *to);
-	void newFormulaGenerated(AST::LogicStatement *formula);
+	void newFormulaGenerated(const Formula &formula);
 
 	void ShowContextMenu(const QPoint &point);
 };
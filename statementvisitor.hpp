@@ -0,0 +1,147 @@
+#ifndef STATEMENTVISITOR_HPP
+#define STATEMENTVISITOR_HPP
+
+#include "AST.hpp"
+
+/* Dispatches on the symbol of a statement to a method of Visitor for its
+ * concrete class, without virtual calls or dynamic_cast, so the compiler can
+ * inline the whole pass. A visitor derives from StatementVisitor<Visitor,
+ * Result> and defines the methods it cares about. Methods it leaves out
+ * fall back to the next more general one, e.g. visitAnd to visitBinary and
+ * visitBinary to visitStatement */
+template <class Visitor, class Result = void>
+class StatementVisitor
+{
+	Visitor *visitor()
+	{
+		return static_cast<Visitor *>(this);
+	}
+
+  public:
+	Result visit(AST::LogicStatement *statement);
+
+	Result visitTruth(AST::Truth *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitFalsity(AST::Falsity *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitVariable(AST::Variable *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitNot(AST::NotStatement *statement)
+	{
+		return visitor()->visitUnary(statement);
+	}
+
+	Result visitUnary(AST::UnaryOpStatement *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitAnd(AST::AndStatement *statement)
+	{
+		return visitor()->visitBinary(statement);
+	}
+
+	Result visitOr(AST::OrStatement *statement)
+	{
+		return visitor()->visitBinary(statement);
+	}
+
+	Result visitImplies(AST::ImpliesStatement *statement)
+	{
+		return visitor()->visitBinary(statement);
+	}
+
+	Result visitIff(AST::IffStatement *statement)
+	{
+		return visitor()->visitBinary(statement);
+	}
+
+	Result visitBinary(AST::BinaryOpStatement *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitForAll(AST::ForAllStatement *statement)
+	{
+		return visitor()->visitFirstOrder(statement);
+	}
+
+	Result visitThereExists(AST::ThereExistsStatement *statement)
+	{
+		return visitor()->visitFirstOrder(statement);
+	}
+
+	Result visitPredicate(AST::PredicateSymbolStatement *statement)
+	{
+		return visitor()->visitFirstOrder(statement);
+	}
+
+	Result visitEquality(AST::EqualityStatement *statement)
+	{
+		return visitor()->visitFirstOrder(statement);
+	}
+
+	Result visitFirstOrder(AST::FirstOrderStatement *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+
+	Result visitParameters(AST::Parameters *statement)
+	{
+		return visitor()->visitStatement(statement);
+	}
+};
+
+template <class Visitor, class Result>
+Result StatementVisitor<Visitor, Result>::visit(AST::LogicStatement *statement)
+{
+	switch (statement->getSymbol()) {
+	case VARIABLE_SYMBOL:
+		return visitor()->visitVariable(
+		    static_cast<AST::Variable *>(statement));
+	case TRUTH_SYMBOL:
+		return visitor()->visitTruth(static_cast<AST::Truth *>(statement));
+	case FALSITY_SYMBOL:
+		return visitor()->visitFalsity(static_cast<AST::Falsity *>(statement));
+	case FORALL_SYMBOL:
+		return visitor()->visitForAll(
+		    static_cast<AST::ForAllStatement *>(statement));
+	case NOT_SYMBOL:
+		return visitor()->visitNot(static_cast<AST::NotStatement *>(statement));
+	case AND_SYMBOL:
+		return visitor()->visitAnd(static_cast<AST::AndStatement *>(statement));
+	case OR_SYMBOL:
+		return visitor()->visitOr(static_cast<AST::OrStatement *>(statement));
+	case IMPLIES_SYMBOL:
+		return visitor()->visitImplies(
+		    static_cast<AST::ImpliesStatement *>(statement));
+	case IFF_SYMBOL:
+		return visitor()->visitIff(static_cast<AST::IffStatement *>(statement));
+	case THEREEXISTS_SYMBOL:
+		return visitor()->visitThereExists(
+		    static_cast<AST::ThereExistsStatement *>(statement));
+	case EQUALS_SYMBOL:
+		return visitor()->visitEquality(
+		    static_cast<AST::EqualityStatement *>(statement));
+	case PARAMETERS_SYMBOL:
+		return visitor()->visitParameters(
+		    static_cast<AST::Parameters *>(statement));
+	case PREDICATE_SYMBOL:
+		return visitor()->visitPredicate(
+		    static_cast<AST::PredicateSymbolStatement *>(statement));
+	}
+
+	/* Every symbol is handled above */
+	return Result();
+}
+
+#endif // STATEMENTVISITOR_HPP
@@ -0,0 +1,151 @@
+#ifndef STATEMENTWALKER_HPP
+#define STATEMENTWALKER_HPP
+
+#include <QVarLengthArray>
+#include "AST.hpp"
+
+/* Depth first walks of ASTs on an explicit stack, so statements nested
+ * arbitrarily deep are walked in constant native stack. Frames of shallow
+ * statements stay off the heap */
+class StatementWalker
+{
+	static const int INLINE_FRAMES = 64;
+
+	/* Children are read once, when the walk enters a node */
+	struct Frame
+	{
+		AST::LogicStatement *statement;
+		int stage;
+		AST::LogicStatement *children[2];
+	};
+
+	template <class Frames>
+	static inline void enter(Frames &frames, AST::LogicStatement *statement);
+
+	struct PairFrame
+	{
+		AST::LogicStatement *first;
+		AST::LogicStatement *second;
+		int stage;
+	};
+
+  public:
+	enum Action { CONTINUE, SKIP_CHILDREN, STOP };
+
+	/* Calls visit(statement, stage) on every node of root, with stage 0 on
+	 * arrival and stage k once its k-th child has been walked, so a node
+	 * with n children is visited n + 1 times. SKIP_CHILDREN on arrival
+	 * finishes the node without walking its children, STOP ends the walk.
+	 * Returns false iff the walk was stopped. visit must not replace the
+	 * children of the nodes being walked */
+	template <class Visit>
+	static bool walk(AST::LogicStatement *root, Visit visit);
+
+	/* Walks first and second in step, pairing children by position, with
+	 * visit(first, second, stage). visit must not continue into a pair
+	 * whose children do not pair up */
+	template <class Visit>
+	static bool walkPair(AST::LogicStatement *first,
+	                     AST::LogicStatement *second, Visit visit);
+};
+
+template <class Frames>
+inline void StatementWalker::enter(Frames &frames,
+                                   AST::LogicStatement *statement)
+{
+	frames.append(Frame{statement, 0, {nullptr, nullptr}});
+	statement->getChildren(frames.last().children);
+}
+
+template <class Visit>
+bool StatementWalker::walk(AST::LogicStatement *root, Visit visit)
+{
+	QVarLengthArray<Frame, INLINE_FRAMES> frames;
+	Action action = visit(root, 0);
+
+	if (action == STOP)
+		return false;
+	if (action == CONTINUE)
+		enter(frames, root);
+
+	while (!frames.isEmpty()) {
+		Frame &frame = frames.last();
+		AST::LogicStatement *child =
+		    frame.stage < 2 ? frame.children[frame.stage] : nullptr;
+
+		if (child == nullptr) {
+			frames.removeLast();
+			if (frames.isEmpty())
+				break;
+
+			Frame &parent = frames.last();
+			if (visit(parent.statement, ++parent.stage) == STOP)
+				return false;
+			continue;
+		}
+
+		action = visit(child, 0);
+
+		if (action == STOP)
+			return false;
+		if (action == CONTINUE) {
+			enter(frames, child);
+			continue;
+		}
+
+		if (visit(frame.statement, ++frame.stage) == STOP)
+			return false;
+	}
+
+	return true;
+}
+
+template <class Visit>
+bool StatementWalker::walkPair(AST::LogicStatement *first,
+                               AST::LogicStatement *second, Visit visit)
+{
+	QVarLengthArray<PairFrame, INLINE_FRAMES> frames;
+	Action action = visit(first, second, 0);
+
+	if (action == STOP)
+		return false;
+	if (action == CONTINUE)
+		frames.append(PairFrame{first, second, 0});
+
+	while (!frames.isEmpty()) {
+		PairFrame &frame = frames.last();
+		AST::LogicStatement *firstChild = frame.first->getChild(frame.stage);
+
+		if (firstChild == nullptr) {
+			frames.removeLast();
+			if (frames.isEmpty())
+				break;
+
+			PairFrame &parent = frames.last();
+			if (visit(parent.first, parent.second, ++parent.stage) == STOP)
+				return false;
+			continue;
+		}
+
+		AST::LogicStatement *secondChild = frame.second->getChild(frame.stage);
+
+		if (secondChild == nullptr)
+			return false;
+
+		action = visit(firstChild, secondChild, 0);
+
+		if (action == STOP)
+			return false;
+		if (action == CONTINUE) {
+			frames.append(PairFrame{firstChild, secondChild, 0});
+			continue;
+		}
+
+		if (visit(frame.first, frame.second, ++frame.stage) == STOP)
+			return false;
+	}
+
+	return true;
+}
+
+#endif // STATEMENTWALKER_HPP
@@ -7,7 +7,9 @@
 #include <QLabel>
 #include <QPair>
 
-typedef EmbeddedPushButton<AST::LogicStatement *> SubformulaButton;
+/* Buttons carry the preorder number of their subformula, the path is only
+ * built for the one clicked */
+typedef EmbeddedPushButton<int> SubformulaButton;
 
 SubformulaSelectionDialog::SubformulaSelectionDialog(
     AST::LogicStatement *formula, QWidget *parent)
@@ -16,12 +18,22 @@ SubformulaSelectionDialog::SubformulaSelectionDialog(
 {
 	ui->setupUi(this);
 
+	QHash<AST::LogicStatement *, int> numbers =
+	    FormulaPath::preorder(formula);
+
+	/* Tooltips are cut out of one print, printing every subformula on its
+	 * own would take time quadratic in the depth */
+	QString print;
+	QHash<AST::LogicStatement *, QPair<int, int> > spans;
+	formula->print(ET::fullBracket, &print, &spans);
+
 	for (QPair<QString, AST::LogicStatement *> i :
 	     formula->getStringMapping(ET::fullBracket)) {
 		QWidget *sfw;
 		if (i.second != nullptr) {
-			sfw = new SubformulaButton(i.first, i.second, this);
-			sfw->setToolTip(i.second->print(ET::fullBracket));
+			QPair<int, int> span = spans.value(i.second);
+			sfw = new SubformulaButton(i.first, numbers.value(i.second), this);
+			sfw->setToolTip(print.mid(span.first, span.second));
 			connect(sfw, SIGNAL(clicked()), this, SLOT(onClick()));
 		} else {
 			sfw = new QLabel(i.first, this);
@@ -38,6 +50,7 @@ SubformulaSelectionDialog::~SubformulaSelectionDialog()
 void SubformulaSelectionDialog::onClick()
 {
 	SubformulaButton *sBtn = static_cast<SubformulaButton *>(sender());
-	emit subformulaSelected(sBtn->getExtra());
+	emit subformulaSelected(
+	    FormulaPath::ofPreorder(fullFormula, sBtn->getExtra()));
 	close();
 }
@@ -5,6 +5,7 @@
 #include <QAbstractButton>
 
 #include "AST.hpp"
+#include "formulapath.hpp"
 
 namespace Ui
 {
@@ -24,7 +25,7 @@ class SubformulaSelectionDialog : public QDialog
 	~SubformulaSelectionDialog();
 
 signals:
-	void subformulaSelected(AST::LogicStatement *);
+	void subformulaSelected(const FormulaPath &);
 
   private
 slots:
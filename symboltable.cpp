@@ -0,0 +1,64 @@
+#include "symboltable.hpp"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+SymbolTable::SymbolTable()
+{
+}
+
+SymbolTable::~SymbolTable()
+{
+	qDeleteAll(spellings);
+}
+
+SymbolTable *SymbolTable::globalTable()
+{
+	static SymbolTable table;
+	return &table;
+}
+
+quint32 SymbolTable::intern(const QString &spelling)
+{
+	{
+		QReadLocker locker(&lock);
+		auto id = ids.constFind(spelling);
+
+		if (id != ids.constEnd())
+			return id.value();
+	}
+
+	QWriteLocker locker(&lock);
+
+	/* Another thread may have added it between the two locks */
+	auto id = ids.constFind(spelling);
+	if (id != ids.constEnd())
+		return id.value();
+
+	/* Deep copy, spelling may be raw data borrowed from a buffer */
+	QString *copy = new QString(spelling.constData(), spelling.size());
+	quint32 newId = quint32(spellings.size());
+	spellings.append(copy);
+	ids.insert(*copy, newId);
+	return newId;
+}
+
+quint32 SymbolTable::intern(const QChar *spelling, int length)
+{
+	return intern(QString::fromRawData(spelling, length));
+}
+
+const QString &SymbolTable::spelling(quint32 id)
+{
+	QReadLocker locker(&lock);
+
+	/* Spellings are heap allocated so the reference survives the vector
+	 * growing */
+	return *spellings.at(int(id));
+}
+
+int SymbolTable::size()
+{
+	QReadLocker locker(&lock);
+	return spellings.size();
+}
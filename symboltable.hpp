@@ -0,0 +1,38 @@
+#ifndef SYMBOLTABLE_HPP
+#define SYMBOLTABLE_HPP
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/* Maps identifier spellings to dense ids, so identifiers can be compared as
+ * integers. Ids are handed out in order of first appearance and are never
+ * reused, spellings stay valid for the lifetime of the application */
+class SymbolTable
+{
+	QHash<QString, quint32> ids;
+	QVector<QString *> spellings;
+	QReadWriteLock lock;
+
+	SymbolTable();
+
+  public:
+	~SymbolTable();
+
+	/* Shared table for the whole application */
+	static SymbolTable *globalTable();
+
+	/* Returns the id of a spelling, assigning the next one if it is new */
+	quint32 intern(const QString &spelling);
+
+	/* Same for a spelling inside a larger buffer, which is only copied
+	 * when the spelling is new */
+	quint32 intern(const QChar *spelling, int length);
+
+	const QString &spelling(quint32 id);
+
+	int size();
+};
+
+#endif // SYMBOLTABLE_HPP
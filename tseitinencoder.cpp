@@ -0,0 +1,128 @@
+#include "tseitinencoder.hpp"
+#include "statementwalker.hpp"
+#include "symboltable.hpp"
+
+using namespace AST;
+
+TseitinEncoder::TseitinEncoder(SatSolver *solver) : solver(solver)
+{
+	/* Constants share one variable that is forced to true */
+	trueLiteral = SatSolver::literal(solver->newVariable(), false);
+	solver->addClause(QVector<int>() << trueLiteral);
+}
+
+int TseitinEncoder::gate()
+{
+	return SatSolver::literal(solver->newVariable(), false);
+}
+
+int TseitinEncoder::encodeXor(int left, int right)
+{
+	int output = gate();
+	int notOutput = SatSolver::negate(output);
+	int notLeft = SatSolver::negate(left);
+	int notRight = SatSolver::negate(right);
+
+	solver->addClause(QVector<int>() << notOutput << left << right);
+	solver->addClause(QVector<int>() << notOutput << notLeft << notRight);
+	solver->addClause(QVector<int>() << output << notLeft << right);
+	solver->addClause(QVector<int>() << output << left << notRight);
+
+	return output;
+}
+
+int TseitinEncoder::encode(LogicStatement *statement)
+{
+	/* Literals of children whose parent is not encoded yet */
+	QVector<int> pending;
+
+	StatementWalker::walk(statement, [this, &pending](LogicStatement *node,
+	                                                  int stage) {
+		if (node->getChild(stage) != nullptr)
+			return StatementWalker::CONTINUE;
+
+		int first = pending.size() - stage;
+		int left = stage > 0 ? pending.at(first) : trueLiteral;
+		int right = stage > 1 ? pending.at(first + 1) : trueLiteral;
+
+		pending.resize(first);
+		pending.append(encodeNode(node, left, right));
+		return StatementWalker::CONTINUE;
+	});
+
+	return pending.last();
+}
+
+int TseitinEncoder::encodeNode(LogicStatement *node, int left, int right)
+{
+	switch (node->getSymbol()) {
+	case VARIABLE_SYMBOL: {
+		quint32 id = static_cast<Variable *>(node)->getId();
+
+		if (!variables.contains(id))
+			variables.insert(id, solver->newVariable());
+
+		return SatSolver::literal(variables.value(id), false);
+	}
+	case TRUTH_SYMBOL:
+		return trueLiteral;
+	case FALSITY_SYMBOL:
+		return SatSolver::negate(trueLiteral);
+	case NOT_SYMBOL:
+		/* Negation needs no gate, only the literal is flipped */
+		return SatSolver::negate(left);
+	case IFF_SYMBOL:
+		return SatSolver::negate(encodeXor(left, right));
+	case IMPLIES_SYMBOL:
+		/* A -> B is encoded as NOT A OR B */
+		left = SatSolver::negate(left);
+		break;
+	default:
+		break;
+	}
+
+	int output = gate();
+	int notOutput = SatSolver::negate(output);
+	int notLeft = SatSolver::negate(left);
+	int notRight = SatSolver::negate(right);
+
+	if (node->getSymbol() == AND_SYMBOL) {
+		solver->addClause(QVector<int>() << notOutput << left);
+		solver->addClause(QVector<int>() << notOutput << right);
+		solver->addClause(QVector<int>() << output << notLeft << notRight);
+	} else {
+		solver->addClause(QVector<int>() << output << notLeft);
+		solver->addClause(QVector<int>() << output << notRight);
+		solver->addClause(QVector<int>() << notOutput << left << right);
+	}
+
+	return output;
+}
+
+bool TseitinEncoder::isEquivalent(LogicStatement *start, LogicStatement *end,
+                                  QMap<QString, bool> *counterexample)
+{
+	SatSolver solver;
+	TseitinEncoder encoder(&solver);
+
+	int difference =
+	    encoder.encodeXor(encoder.encode(start), encoder.encode(end));
+
+	/* Any model of the miter is an assignment telling both formulas apart */
+	if (!solver.addClause(QVector<int>() << difference))
+		return true;
+
+	if (!solver.solve())
+		return true;
+
+	if (counterexample) {
+		counterexample->clear();
+		for (auto variable = encoder.variables.constBegin();
+		     variable != encoder.variables.constEnd(); ++variable)
+			counterexample->insert(
+			    SymbolTable::globalTable()->spelling(variable.key()),
+			    solver.modelValue(variable.value()));
+	}
+
+	return false;
+}
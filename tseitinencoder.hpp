@@ -0,0 +1,41 @@
+#ifndef TSEITINENCODER_HPP
+#define TSEITINENCODER_HPP
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include "AST.hpp"
+#include "satsolver.hpp"
+
+/* Translates propositional formulas into clauses of a SatSolver, introducing
+ * one gate variable per connective so the clause set stays linear in the
+ * size of the formula */
+class TseitinEncoder
+{
+	SatSolver *solver;
+	QHash<quint32, int> variables;
+	int trueLiteral;
+
+	int gate();
+
+	/* Literal of node given the literals of its children */
+	int encodeNode(AST::LogicStatement *node, int left, int right);
+
+  public:
+	TseitinEncoder(SatSolver *solver);
+
+	/* Returns a literal that is true exactly when the statement is true */
+	int encode(AST::LogicStatement *statement);
+
+	/* Returns a literal that is true exactly when both literals differ */
+	int encodeXor(int left, int right);
+
+	/* Returns true iff the two propositional formulas are equivalent, i.e.
+	 * start XOR end is unsatisfiable, otherwise counterexample, when given,
+	 * receives a model of start XOR end */
+	static bool isEquivalent(AST::LogicStatement *start,
+	                         AST::LogicStatement *end,
+	                         QMap<QString, bool> *counterexample = nullptr);
+};
+
+#endif // TSEITINENCODER_HPP